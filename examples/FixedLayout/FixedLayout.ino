@@ -0,0 +1,94 @@
+/*! @file FixedLayout.ino
+
+@section FixedLayout_intro_section Description
+
+Example program for the MB85_FRAM_Fixed class, which is used instead of MB85_FRAM_Class when the
+Fujitsu FRAM memories on the I2C bus are known when the program is written. The memory types are
+given as template parameters in I2C address order starting at 0x50, so no detection is done in
+begin() and all address calculations are done with constants. This makes the program smaller and
+the reads and writes faster than with MB85_FRAM_Class, but the program has to be changed when the
+memories are changed.\n\n
+
+The program makes use of the https://github.com/Zanduino/MB85_FRAM library, the most recent version
+of which can be downloaded at https://github.com/Zanduino/MB85_FRAM/archive/master.zip \n\n
+
+The example expects two MB85RC256V memories at I2C addresses 0x50 and 0x51. The read() and write()
+functions support any data type in the same way as those of MB85_FRAM_Class.
+
+@section FixedLayoutlicense GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section FixedLayoutauthor Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section FixedLayoutversions Changelog
+
+Version | Date       | Developer  | Comments
+------- | ---------- | ---------- | ---------------------------------------------------
+1.0.0   | 2026-10-16 | SV-Zanshin | Initial coding
+*/
+#include <MB85_FRAM_Fixed.h>  // Include the MB85_FRAM compile-time layout template
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED = 115200;  ///< Set the baud rate for Serial I/O
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+MB85_FRAM_Fixed<MB85RC256V, MB85RC256V> FRAM;  ///< Two MB85RC256V memories at 0x50 and 0x51
+
+/*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+*/
+void setup() {
+  Serial.begin(SERIAL_SPEED);  // Start serial port at Baud rate
+#ifdef __AVR_ATmega32U4__      // If this is a 32U4 processor, then wait 3 seconds to initialize USB
+  delay(3000);
+#endif
+  Serial.println("Starting FRAM fixed layout example program");
+  FRAM.begin(I2C_FAST_MODE);  // Start the I2C bus, the memories aren't probed
+  Serial.print("Total storage ");
+  Serial.print(FRAM.totalBytes());
+  Serial.println(" bytes.\nWriting a counter value to each memory.");
+  for (uint32_t i = 0; i < FRAM.CHIPS; i++) {
+    FRAM.write(i * FRAM.memSize(0), i * 1000);
+  }  // of for-next each memory
+  for (uint32_t i = 0; i < FRAM.CHIPS; i++) {
+    uint32_t value = 0;
+    FRAM.read(i * FRAM.memSize(0), value);
+    Serial.print("Memory ");
+    Serial.print(i);
+    Serial.print(" value ");
+    Serial.println(value);
+  }  // of for-next each memory
+
+  Serial.println("Writing array across the 2 memories.");
+  char testArray[13] = "Hello World!";
+  FRAM.write(FRAM.memSize(0) - 6, testArray);  // Split test string across 2 chips
+  FRAM.read(FRAM.memSize(0), testArray);       // Read the second half from the 2nd memory
+  Serial.print("Reading from memory 2 gives text \"");
+  Serial.print(testArray);
+  Serial.println("\".");
+  Serial.println("\n\nFinished.");
+}  // of method setup()
+
+/*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+*/
+void loop() {}  // of method loop()
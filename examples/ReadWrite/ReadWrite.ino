@@ -15,18 +15,16 @@ The program makes use of the https://github.com/Zanduino/MB85_FRAM library, the
 of which can be downloaded at https://github.com/Zanduino/MB85_FRAM/archive/master.zip \n\n
 
 The following memories in the MB85 are detected and supported:\n\n
+MB85RC1MT    1Mbit (128K x 8bit) ManufacturerID 0x00A, Product ID = 0x758 (Density = 0x7)\n
 MB85RC512T 512Kbit ( 64K x 8bit) ManufacturerID 0x00A, Product ID = 0x658 (Density = 0x6)\n
 MB85RC256V 256Kbit ( 32K x 8bit) ManufacturerID 0x00A, Product ID = 0x510 (Density = 0x5)\n
 MB85RC128A 128Kbit ( 16K x 8bit) No ManufacturerID/productID or Density values\n
 MB85RC64TA  64Kbit (  8K x 8bit) No ManufacturerID/productID or Density values\n
 MB85RC64A   64Kbit (  8K x 8bit) No ManufacturerID/productID or Density values\n
-MB85RC64V   64Kbit (  8K x 8bit) No ManufacturerID/productID or Density values\n\n
-- unsupported memories --\n\n
-MB85RC1MT    1Mbit (128K x 8bit) ManufacturerID 0x00A, Product ID = 0x758 (Density = 0x7)
-(unsupported)\n MB85RC16    16Kbit (  2K x 8bit) No ManufacturerID/productID or Density values  1
-Address byte   (unsupported)\n MB85RC16V   16Kbit (  2K x 8bit) No ManufacturerID/productID or
-Density values  1 Address byte   (unsupported)\n MB85RC04V    4Kbit ( 512 x 8bit) No
-ManufacturerID/productID or Density values  1 Address byte   (unsupported)\n\n
+MB85RC64V   64Kbit (  8K x 8bit) No ManufacturerID/productID or Density values\n
+MB85RC16    16Kbit (  2K x 8bit) No ManufacturerID/productID or Density values, 1 Address byte\n
+MB85RC16V   16Kbit (  2K x 8bit) No ManufacturerID/productID or Density values, 1 Address byte\n
+MB85RC04V    4Kbit ( 512 x 8bit) No ManufacturerID/productID or Density values, 1 Address byte\n\n
 
 What sets this library apart is that it will autmatically detect up to 8 memories, in any
 combination of those listed as supported above, and treats them as one contiguous block of memory.
@@ -69,6 +67,7 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 Version | Date       | Developer  | Comments
 ------- | ---------- | ---------- | ---------------------------------------------------
+1.0.2   | 2026-10-16 | SV-Zanshin | MB85RC1MT, MB85RC16 and MB85RC04V are supported
 1.0.1   | 2019-01-27 | SV-Zanshin | Issue #4 - convert documentation to Doxygen
 1.0.0   | 2017-08-27 | SV-Zanshin | Initial coding
 */
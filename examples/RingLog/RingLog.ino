@@ -0,0 +1,104 @@
+/*! @file RingLog.ino
+
+@section RingLog_intro_section Description
+
+Example program for the MB85_FRAM_RingLog class. A ring log is kept in the first 4kB of the FRAM
+memory, every start of the program appends a record and a record with the time is appended every
+few seconds. At startup the log is recovered and all records logged before the last reset or power
+failure are listed, so the example can be reset or switched off at any time to show that the log
+survives. The oldest records are dropped once the log is full.\n\n
+
+The program makes use of the https://github.com/Zanduino/MB85_FRAM library, the most recent version
+of which can be downloaded at https://github.com/Zanduino/MB85_FRAM/archive/master.zip \n\n
+
+The example expects at least one MB85RC memory of 4kB or more on the I2C bus.
+
+@section RingLoglicense GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section RingLogauthor Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section RingLogversions Changelog
+
+Version | Date       | Developer  | Comments
+------- | ---------- | ---------- | ---------------------------------------------------
+1.0.0   | 2026-10-16 | SV-Zanshin | Initial coding
+*/
+#include <MB85_FRAM.h>          // Include the MB85_FRAM library
+#include <MB85_FRAM_RingLog.h>  // Include the persistent ring log
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED = 115200;  ///< Set the baud rate for Serial I/O
+const uint32_t LOG_START    = 0;       ///< Memory address of the log region
+const uint32_t LOG_SIZE     = 4096;    ///< Bytes in the log region
+const uint32_t LOG_INTERVAL = 5000;    ///< Milliseconds between two time records
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+MB85_FRAM_Class   FRAM;                                ///< Memories on the I2C bus
+MB85_FRAM_RingLog logBook(FRAM, LOG_START, LOG_SIZE);  ///< Ring log in the memory
+char              text[64];                            ///< Record text
+uint32_t          lastRecord = 0;                      ///< millis() of the last time record
+
+/*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+*/
+void setup() {
+  Serial.begin(SERIAL_SPEED);  // Start serial port at Baud rate
+#ifdef __AVR_ATmega32U4__      // If this is a 32U4 processor, then wait 3 seconds to initialize USB
+  delay(3000);
+#endif
+  Serial.println("Starting FRAM ring log example program");
+  FRAM.begin();
+  if (!logBook.begin()) {  // Recover the log or create an empty one
+    Serial.println("The log region doesn't fit into the memory.");
+    while (true) delay(1000);
+  }  // of if-then log not ready
+  Serial.print("Found ");
+  Serial.print(logBook.records());
+  Serial.print(" records using ");
+  Serial.print(logBook.usedBytes());
+  Serial.print(" of ");
+  Serial.print(logBook.capacity());
+  Serial.println(" bytes:");
+  uint32_t cursor = logBook.oldest();
+  for (uint32_t i = 0; i < logBook.records(); i++) {
+    uint16_t length = logBook.readNext(cursor, text, sizeof(text) - 1);
+    text[length < sizeof(text) - 1 ? length : sizeof(text) - 1] = '\0';
+    Serial.print(logBook.firstRecord() + i);
+    Serial.print(": ");
+    Serial.println(text);
+  }  // of for-next each record
+  sprintf(text, "Started, record %lu", (unsigned long)(logBook.firstRecord() + logBook.records()));
+  logBook.append(text, strlen(text));
+}  // of method setup()
+
+/*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+*/
+void loop() {
+  if (millis() - lastRecord >= LOG_INTERVAL) {
+    lastRecord = millis();
+    sprintf(text, "Running for %lu seconds", (unsigned long)(lastRecord / 1000));
+    logBook.append(text, strlen(text));  // A power failure never leaves half a record
+    Serial.println(text);
+  }  // of if-then time to log
+}  // of method loop()
@@ -0,0 +1,99 @@
+/*! @file SPIMemory.ino
+
+@section SPIMemory_intro_section Description
+
+Example program for MB85RS memories on the SPI bus. The SPI bus and the chip select pin of each
+memory are passed to the MB85_FRAM_SPI_Class constructor from "MB85_FRAM_SPI.h", after which the
+memories are used with exactly the same functions as the I2C memories. The memory size is read
+with the RDID command in begin(), the MB85RS64 doesn't support the command and has to be passed to
+begin() as a known layout.\n\n
+
+The program makes use of the https://github.com/Zanduino/MB85_FRAM library, the most recent version
+of which can be downloaded at https://github.com/Zanduino/MB85_FRAM/archive/master.zip \n\n
+
+The example expects two MB85RS memories, e.g. MB85RS256B, with their chip select lines on pins 10
+and 9 and runs the SPI bus at 20MHz.
+
+@section SPIMemorylicense GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section SPIMemoryauthor Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section SPIMemoryversions Changelog
+
+Version | Date       | Developer  | Comments
+------- | ---------- | ---------- | ---------------------------------------------------
+1.0.0   | 2026-10-16 | SV-Zanshin | Initial coding
+*/
+#include <MB85_FRAM.h>      // Include the MB85_FRAM library
+#include <MB85_FRAM_SPI.h>  // Include the SPI memory class
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED = 115200;   ///< Set the baud rate for Serial I/O
+const uint8_t  CS_PINS[]    = {10, 9};  ///< Chip select pin of each memory
+const uint8_t  CHIP_COUNT   = 2;        ///< Number of entries in CS_PINS[]
+const uint32_t BLOCK_BYTES  = 1024;     ///< Bytes in the test block
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+MB85_FRAM_SPI_Class FRAM(SPI, CS_PINS, CHIP_COUNT);  ///< Memories on the SPI bus
+uint8_t             block[BLOCK_BYTES];              ///< Test block
+
+/*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+*/
+void setup() {
+  Serial.begin(SERIAL_SPEED);  // Start serial port at Baud rate
+#ifdef __AVR_ATmega32U4__      // If this is a 32U4 processor, then wait 3 seconds to initialize USB
+  delay(3000);
+#endif
+  Serial.println("Starting FRAM SPI example program");
+  uint8_t memories = FRAM.begin();  // Identify the memories on the chip select pins
+  Serial.print("Found ");
+  Serial.print(memories);
+  Serial.print(" memories with a total of ");
+  Serial.print(FRAM.totalBytes());
+  Serial.println(" bytes.");
+  if (memories == 0) return;
+  for (uint16_t i = 0; i < BLOCK_BYTES; i++) block[i] = i;
+  uint32_t address = FRAM.memSize(0) - BLOCK_BYTES / 2;  // Split the block across the memories
+  uint32_t start   = micros();
+  FRAM.writeBlock(address, block, BLOCK_BYTES);  // One WRITE command for each memory
+  uint32_t elapsed = micros() - start;
+  Serial.print("Wrote ");
+  Serial.print(BLOCK_BYTES);
+  Serial.print(" bytes in ");
+  Serial.print(elapsed);
+  Serial.println(" microseconds.");
+  memset(block, 0, BLOCK_BYTES);
+  FRAM.readBlock(address, block, BLOCK_BYTES);
+  uint16_t errors = 0;
+  for (uint16_t i = 0; i < BLOCK_BYTES; i++) errors += block[i] != (uint8_t)i;
+  Serial.print("Read back with ");
+  Serial.print(errors);
+  Serial.println(" errors.");
+  Serial.println("\n\nFinished.");
+}  // of method setup()
+
+/*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+*/
+void loop() {}  // of method loop()
@@ -0,0 +1,89 @@
+/*! @file StreamDump.ino
+
+@section StreamDump_intro_section Description
+
+Example program for the MB85_FRAM_Stream class and the MB85_FRAM_Array template. An array of 256
+unsigned integers is kept in the memory and incremented element by element at every start of the
+program, then the first 1kB of the memory is dumped over the serial port in hexadecimal. Both go
+through buffers of the size of the I2C buffer, so sequential access takes one memory address per
+I2C transmission rather than one per element or byte.\n\n
+
+The program makes use of the https://github.com/Zanduino/MB85_FRAM library, the most recent version
+of which can be downloaded at https://github.com/Zanduino/MB85_FRAM/archive/master.zip \n\n
+
+The example expects at least one MB85RC memory of 4kB or more on the I2C bus.
+
+@section StreamDumplicense GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section StreamDumpauthor Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section StreamDumpversions Changelog
+
+Version | Date       | Developer  | Comments
+------- | ---------- | ---------- | ---------------------------------------------------
+1.0.0   | 2026-10-16 | SV-Zanshin | Initial coding
+*/
+#include <MB85_FRAM.h>        // Include the MB85_FRAM library
+#include <MB85_FRAM_Array.h>  // Include the buffered array and stream
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED = 115200;  ///< Set the baud rate for Serial I/O
+const uint32_t ARRAY_START  = 2048;    ///< Memory address of the array
+const uint16_t ARRAY_COUNT  = 256;     ///< Number of array elements
+const uint16_t DUMP_BYTES   = 1024;    ///< Bytes dumped from the start of the memory
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+MB85_FRAM_Class FRAM;  ///< Memories on the I2C bus
+
+/*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+*/
+void setup() {
+  Serial.begin(SERIAL_SPEED);  // Start serial port at Baud rate
+#ifdef __AVR_ATmega32U4__      // If this is a 32U4 processor, then wait 3 seconds to initialize USB
+  delay(3000);
+#endif
+  Serial.println("Starting FRAM stream example program");
+  FRAM.begin();
+  MB85_FRAM_Array<uint16_t> counters(FRAM, ARRAY_START, ARRAY_COUNT);
+  for (uint16_t i = 0; i < ARRAY_COUNT; i++) counters[i] = counters[i] + 1;
+  counters.flush();  // Write out the last elements
+  Serial.print("Counters incremented, the first is now ");
+  Serial.println(counters.get(0));
+  MB85_FRAM_Stream stream(FRAM, 0, DUMP_BYTES);
+  char             text[12];
+  while (stream.available()) {
+    if (stream.position() % 16 == 0) {
+      sprintf(text, "\n%04lX:", (unsigned long)stream.position());
+      Serial.print(text);
+    }  // of if-then start of a line
+    sprintf(text, " %02X", stream.read());
+    Serial.print(text);
+  }  // of while bytes left to dump
+  Serial.println("\n\nFinished.");
+}  // of method setup()
+
+/*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+*/
+void loop() {}  // of method loop()
@@ -0,0 +1,1653 @@
+/*! @file Benchmark.cpp
+
+ @section Benchmark_intro_section Description
+
+ Host-side benchmark for the MB85_FRAM library. The library is compiled against the simulated
+ "Wire" and "SPI" libraries in extras/host, which model up to 8 MB85RC memories at I2C addresses
+ 0x50 to 0x57 and MB85RS memories on chip select pins, and count every bus transaction. As the
+ simulated buses take no time, throughput is given in bytes per second of bus time at each bus speed
+ and CPU time is that of the library and the simulation.\n\n
+
+ Each test prints the transactions, address-phase and payload bytes per call and the share of the
+ bus used for addressing. The tests cover:\n
+ - typical reads and writes for several memory layouts, with and without MB85_FRAM_Cache, on one
+   bus and contiguous or striped across two buses\n
+ - detection of every memory type by begin() with random, zeroed and incrementing contents, and of
+   the MB85RS memories through the RDID command\n
+ - MB85_FRAM_Class against MB85_FRAM_Fixed, and I2C against SPI at 20MHz and 40MHz\n
+ - asynchronous transfers through attachQueue() and poll()\n
+ - fill(), copy() and compare() against byte-by-byte access and the ideal bus time\n
+ - the retries and per-memory counters with failing transactions, for both classes\n
+ - failing transactions in a striped compare(), the cache, the ring log and the key value store\n
+ - MB85_FRAM_RingLog recovery after a power failure and MB85_FRAM_KVStore lookups\n
+ - MB85_FRAM_Stream, MB85_FRAM_Array and MB85_FRAM_Batch against separate calls\n\n
+
+ All data written is read back and compared. Mismatches are reported in the "Err" column and cause
+ a non-zero exit code.\n\n
+
+ Build and run from the library root directory with:\n
+ g++ -std=gnu++11 -O2 -Wall -Iextras/host -Isrc -o fram_benchmark extras/benchmark/Benchmark.cpp
+ extras/host/Arduino.cpp extras/host/Wire.cpp extras/host/SPI.cpp src/MB85_FRAM.cpp
+ src/MB85_FRAM_RingLog.cpp src/MB85_FRAM_KVStore.cpp src/MB85_FRAM_Stream.cpp
+ src/MB85_FRAM_Batch.cpp && ./fram_benchmark\n
+ Add e.g. -DMB85_FRAM_GRANULES=0 to check the smaller build options.
+
+ @section Benchmark_license GNU General Public License v3.0
+
+ This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+ General Public License as published by the Free Software Foundation, either version 3 of the
+ License, or (at your option) any later version. This program is distributed in the hope that it
+ will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should
+ have received a copy of the GNU General Public License along with this program.  If not, see
+ <http://www.gnu.org/licenses/>.
+*/
+#include <stdio.h>  // printf()
+
+#include "MB85_FRAM.h"        // Include the MB85_FRAM library
+#include "MB85_FRAM_Array.h"  // Include the buffered array template
+#include "MB85_FRAM_Batch.h"  // Include the scatter/gather queue
+#include "MB85_FRAM_Cache.h"  // Include the optional write-back cache
+#include "MB85_FRAM_Fixed.h"  // Include the compile-time layout template
+#include "MB85_FRAM_KVStore.h"  // Include the key value store
+#include "MB85_FRAM_RingLog.h"  // Include the persistent ring log
+#include "MB85_FRAM_SPI.h"      // Include the SPI memory class
+
+/***************************************************************************************************
+** Declare all program constants and structures                                                   **
+***************************************************************************************************/
+const uint32_t SPEEDS[] = {I2C_STANDARD_MODE, I2C_FAST_MODE, I2C_FAST_MODE_PLUS_MODE,
+                           I2C_HIGH_SPEED_MODE};  ///< Bus speeds to report
+const uint8_t  SPEED_COUNT{4};                     ///< Number of entries in SPEEDS[]
+const uint16_t SCALAR_CALLS{1024};                 ///< Number of scalar reads and writes
+const uint16_t STRUCT_CALLS{64};                   ///< Number of structure reads and writes
+const uint16_t CROSS_CALLS{16};                    ///< Number of cross-chip reads and writes
+const uint16_t BLOCK_CALLS{8};                     ///< Number of bulk block reads and writes
+const uint16_t BLOCK_SIZE{4096};                   ///< Bytes in each bulk block
+const uint16_t FIELD_CALLS{512};                   ///< Number of scattered counter updates
+const uint8_t  FIELD_COUNT{48};                    ///< Number of 2 byte counters updated
+const uint16_t FIELD_BASE{1000};                   ///< Memory address of the first counter
+const uint8_t  FIELD_STRIDE{6};                    ///< Distance between counters in bytes
+const uint16_t BUS_BLOCK_SIZE{16384};              ///< Bytes in each multi-bus block
+const uint16_t FIXED_CALLS{20000};                 ///< Number of timed scalar reads and writes
+const uint32_t LOG_START{32768 - 5000};            ///< Ring log region, across a memory boundary
+const uint32_t LOG_SIZE{20000};                    ///< Bytes in the ring log region
+const uint16_t LOG_CALLS{2000};                    ///< Number of single record appends
+const uint8_t  LOG_BATCH{8};                       ///< Records in each batched append
+const uint32_t KV_START{40000};                    ///< Key value store region
+const uint16_t KV_BUCKETS{509};                    ///< Buckets in the key value store
+const uint16_t KV_RECORDS{400};                    ///< Records put into the key value store
+const uint32_t KV_TABLE{70000};                    ///< Plain table of the same records
+const uint8_t  KV_VALUE{16};                       ///< Bytes in each value
+const uint16_t KV_CALLS{1000};                     ///< Number of timed lookups
+const uint16_t KV_FAILURES{16};                    ///< Updates with a failing bucket read
+const uint32_t STATS_START{30000};                 ///< Block written with bus failures
+const uint16_t STATS_BYTES{8192};                  ///< Bytes in the block, across memories
+const uint32_t ARRAY_START{30000};                 ///< First element, across a memory boundary
+const uint16_t ARRAY_COUNT{4096};                  ///< Number of uint16_t elements
+const uint32_t IMAGE_START{16384};                 ///< Memory image dumped through the stream
+const uint32_t IMAGE_BYTES{32768};                 ///< Bytes in the image, across a boundary
+const uint16_t BATCH_CYCLES{500};                  ///< Number of control cycles
+const uint8_t  BATCH_FIELDS{12};                   ///< Fields read or written in each cycle
+const uint8_t  SPI_CS_PINS[SIM_SPI_CHIPS] = {10, 9, 8, 7, 6, 5, 4, 3};  ///< Chip select pins
+const uint32_t SPI_CLOCKS[]               = {20000000, 40000000};       ///< SPI clocks to compare
+const uint8_t  SPI_CLOCK_COUNT{2};                                      ///< Entries in SPI_CLOCKS[]
+const uint8_t  COMPARE_OPS{5};  ///< Operations compared between I2C and SPI
+const char    *COMPARE_NAMES[COMPARE_OPS] = {"write(uint32_t)", "read(uint32_t)",
+                                             "writeBlock(4096)", "readBlock(4096)",
+                                             "poll() fill"};  ///< Names of the operations
+
+/*! @brief  A memory layout to simulate, chip sizes in bytes by I2C address offset (0 = absent) */
+struct Layout {
+  const char *name;                    ///< Description of the layout
+  uint32_t    bytes[SIM_MAX_CHIPS];    ///< Chip size at 0x50 + index
+  uint16_t    product[SIM_MAX_CHIPS];  ///< Device ID product code, 0 if the chip has none
+};
+
+/*! @brief  A memory layout on two buses, "Wire" and "Wire1" */
+struct BusLayout {
+  const char *name;    ///< Description of the layout
+  Layout      bus[2];  ///< Chips on each bus
+};
+
+/*! @brief  Memory contents the memory detection is checked with */
+enum Contents : uint8_t {
+  RANDOM  = 0,  ///< Pseudo-random bytes as set up by the simulator
+  ZEROED  = 1,  ///< All bytes 0
+  ADDRESS = 2   ///< Each byte holds the low byte of its address
+};
+const char *CONTENTS[] = {"random", "zeroed", "address"};  ///< Names of the memory contents
+
+/*! @brief  A 100 byte test structure, larger than the I2C buffer */
+struct Record {
+  uint8_t data[100];  ///< Record contents
+};
+
+/*! @brief  A field read or written in each control cycle */
+struct Field {
+  uint32_t address;  ///< Memory address
+  uint8_t  length;   ///< Bytes in the field
+  bool     write;    ///< Written rather than read
+};
+
+/*! @brief  A memory layout on the simulated SPI bus, chip sizes in bytes by chip select pin */
+struct SpiLayout {
+  const char *name;                    ///< Description of the layout
+  uint32_t    bytes[SIM_SPI_CHIPS];    ///< Chip size on SPI_CS_PINS[index]
+  uint16_t    product[SIM_SPI_CHIPS];  ///< RDID product ID, 0 if the chip has no RDID
+};
+
+/*! @brief  Bus counters of one operation, taken from either the I2C or the SPI simulation */
+struct BusResult {
+  uint32_t calls;         ///< Number of library calls made
+  uint32_t transactions;  ///< I2C transactions or SPI chip select windows
+  uint32_t commandBytes;  ///< I2C address bytes or SPI opcode, address and dummy bytes
+  uint32_t payloadBytes;  ///< Data bytes read or written
+  uint32_t errors;        ///< Mismatched bytes
+  uint64_t clocks;        ///< SCL or SCK clock cycles used
+};
+
+const Layout LAYOUTS[] = {
+    {"4 chips: MB85RC256V, MB85RC256V, MB85RC128A, MB85RC64V",
+     {32768, 32768, 16384, 8192},
+     {0x510, 0x510}},
+    {"8 chips: MB85RC256V x 8",
+     {32768, 32768, 32768, 32768, 32768, 32768, 32768, 32768},
+     {0x510, 0x510, 0x510, 0x510, 0x510, 0x510, 0x510, 0x510}},
+    {"4 chips: MB85RC512T, MB85RC128A, MB85RC64V, MB85RC64V",
+     {65536, 16384, 8192, 8192},
+     {0x658}},
+    {"4 chips: MB85RC1MT, MB85RC1MT, MB85RC04V, MB85RC04V",
+     {131072, 0, 131072, 0, 512, 0, 512},
+     {0x758, 0, 0x758}}};  ///< Layouts to benchmark
+const Layout DETECT_LAYOUTS[] = {
+    {"MB85RC16", {2048}, {0}},
+    {"MB85RC04V x 4", {512, 0, 512, 0, 512, 0, 512}, {0}},
+    {"MB85RC04V, MB85RC64V x 2, MB85RC1MT", {512, 0, 8192, 8192, 131072}, {0, 0, 0, 0, 0x758}},
+    {"MB85RC64V x 8", {8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192}, {0}},
+    {"MB85RC1MT x 4",
+     {131072, 0, 131072, 0, 131072, 0, 131072},
+     {0x758, 0, 0x758, 0, 0x758, 0, 0x758}}};  ///< Layouts to check the memory detection with
+const SpiLayout SPI_LAYOUTS[] = {
+    {"MB85RS256B x 4", {32768, 32768, 32768, 32768}, {0x0509, 0x0509, 0x0509, 0x0509}},
+    {"MB85RS64V, MB85RS1MT, MB85RS2MT, MB85RS4MT",
+     {8192, 131072, 262144, 524288},
+     {0x0302, 0x2703, 0x4803, 0x4903}},
+    {"MB85RS256B, MB85RS64 without RDID, MB85RS1MT",
+     {32768, 8192, 131072},
+     {0x0509, 0, 0x2703}}};  ///< Layouts to check the SPI memory detection with
+const BusLayout BUS_LAYOUTS[] = {
+    {"8 chips: MB85RC256V x 4 on Wire and on Wire1",
+     {{"Wire", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}},
+      {"Wire1", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}}}},
+    {"4 chips: MB85RC512T, MB85RC64V on Wire, MB85RC256V, MB85RC128A on Wire1",
+     {{"Wire", {65536, 8192}, {0x658}}, {"Wire1", {32768, 16384}, {0x510}}}}};  ///< Bus layouts
+const Field CONTROL_FIELDS[BATCH_FIELDS] = {
+    {1000, 4, false}, {1006, 2, false},  {1008, 4, false},  {1016, 2, false},
+    {1020, 4, false}, {2000, 2, true},   {2002, 2, true},   {2004, 4, true},
+    {2008, 2, true},  {32764, 4, false}, {32768, 4, false}, {50000, 4, true}};  ///< Close fields
+
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+uint32_t totalErrors    = 0;  ///< Number of mismatches over all layouts
+uint32_t seed           = 1;  ///< Pseudo-random number generator state
+uint8_t  asyncDoneCount = 0;  ///< Number of completed asynchronous transfers
+uint32_t asyncBytes     = 0;  ///< Bytes reported by the completion callbacks
+
+MB85_Type typeOf(const uint32_t bytes) {
+  /*!
+   * @brief     Return the memory type for a memory size
+   * @param[in] bytes Memory size in bytes, 0 if there is no memory
+   * @return    Memory type, which is log2 of the size
+   */
+  uint8_t bits = 0;
+  while (bytes && (1UL << bits) < bytes) bits++;
+  return (MB85_Type)bits;
+}  // of function "typeOf()"
+uint8_t nextRandom() {
+  /*!
+   * @brief   Return a repeatable pseudo-random byte
+   * @return  Random byte
+   */
+  seed = seed * 1103515245 + 12345;
+  return (uint8_t)(seed >> 16);
+}  // of function "nextRandom()"
+void printHeader() {
+  /*!
+   * @brief   Print the column headings for the result table
+   */
+  printf("%-24s %6s %8s %8s %8s %5s", "Operation", "Calls", "Trans/op", "Addr/op", "Data/op",
+         "Ovh%");
+  for (uint8_t i = 0; i < SPEED_COUNT; i++) printf(" %6ukHz", SPEEDS[i] / 1000);
+  printf(" %5s\n", "Err");
+}  // of function "printHeader()"
+void addStats(I2CStats &sum) {
+  /*!
+   * @brief      Add the current bus counters to a running total and clear the bus counters
+   * @param[out] sum Running total
+   */
+  sum.transactions += Wire.stats.transactions;
+  sum.addressBytes += Wire.stats.addressBytes;
+  sum.payloadBytes += Wire.stats.payloadBytes;
+  sum.naks += Wire.stats.naks;
+  sum.dropped += Wire.stats.dropped;
+  sum.clocks += Wire.stats.clocks;
+  Wire.resetStats();
+}  // of function "addStats()"
+void printResult(const char *operation, const uint32_t calls, const uint32_t errors,
+                 const I2CStats &s = Wire.stats) {
+  /*!
+   * @brief     Print one result line from a set of bus counters
+   * @details   Throughput is payload bytes per second of estimated bus time
+   * @param[in] operation Name of the operation
+   * @param[in] calls Number of library calls made
+   * @param[in] errors Number of mismatched bytes
+   * @param[in] s Bus counters, defaults to the current counters
+   */
+  uint32_t total = s.addressBytes + s.payloadBytes;
+  printf("%-24s %6u %8.2f %8.2f %8.2f %5.1f", operation, calls, (double)s.transactions / calls,
+         (double)s.addressBytes / calls, (double)s.payloadBytes / calls,
+         total ? 100.0 * s.addressBytes / total : 0.0);
+  for (uint8_t i = 0; i < SPEED_COUNT; i++) {
+    double seconds = (double)s.clocks / SPEEDS[i];
+    printf(" %9.0f", seconds > 0 ? s.payloadBytes / seconds : 0.0);
+  }  // of for-next each speed
+  printf(" %5u\n", errors + s.dropped);
+  totalErrors += errors + s.dropped;
+}  // of function "printResult()"
+uint32_t memoryChecksum() {
+  /*!
+   * @brief   Compute a checksum over the contents of all simulated memories
+   * @return  Checksum value
+   */
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    uint32_t       bytes  = 0;
+    const uint8_t *memory = Wire.chipMemory(MB85_MIN_ADDRESS + i, &bytes);
+    for (uint32_t j = 0; j < bytes; j++) sum = sum * 31 + memory[j];
+  }  // of for-next each chip
+  return sum;
+}  // of function "memoryChecksum()"
+template <typename CACHE>
+void cachedFields(MB85_FRAM_Class &FRAM, uint16_t counters[], const char *name) {
+  /*!
+   * @brief     Run the scattered counter updates through a write-back cache
+   * @tparam    CACHE Cache class to use
+   * @param[in] FRAM Memory to use
+   * @param[in] counters Current counter values, updated
+   * @param[in] name Name of the operation to print
+   */
+  Wire.resetStats();
+  {
+    CACHE cache(FRAM);
+    for (uint16_t i = 0; i < FIELD_CALLS; i++) {
+      uint8_t field = nextRandom() % FIELD_COUNT;
+      cache.write(FIELD_BASE + field * FIELD_STRIDE, ++counters[field]);
+    }  // of for-next each update
+    cache.flush();
+  }  // of cache scope
+  I2CStats stats  = Wire.stats;
+  uint32_t errors = 0;
+  for (uint8_t i = 0; i < FIELD_COUNT; i++) {
+    uint16_t value = 0;
+    FRAM.read(FIELD_BASE + i * FIELD_STRIDE, value);
+    errors += value != counters[i];
+  }  // of for-next each counter
+  printResult(name, FIELD_CALLS, errors, stats);
+}  // of function "cachedFields()"
+void cacheFailures(MB85_FRAM_Class &FRAM) {
+  /*!
+   * @brief     Check that the cache neither drops changed bytes nor serves a line it couldn't read
+   * @details   With a single line every access to another line evicts it. Its write-back and the
+   *            read of the next line fail, after which the changed bytes have to reach the memory
+   *            with the next flush() and the next line has to be read again.
+   * @param[in] FRAM Memory to use
+   */
+  const uint32_t         base   = FIELD_BASE + FIELD_COUNT * FIELD_STRIDE + 64;  // Free memory
+  uint16_t               value  = 0;
+  uint32_t               errors = 0;
+  MB85_FRAM_Cache<1, 16> cache(FRAM);
+  FRAM.write(base + 32, (uint16_t)0x1234);  // Contents of the line read after the failure
+  Wire.resetStats();
+  errors += cache.write(base, (uint16_t)0xBEEF) != sizeof(value);
+  FRAM.setRetries(0);
+  Wire.injectNaks(1);
+  errors += cache.write(base + 16, (uint16_t)0x5555) != 0;  // Write-back fails
+  errors += cache.read(base + 32, value) != 0;              // Read fails
+  Wire.injectNaks(0);
+  FRAM.setRetries(MB85_RETRIES);
+  errors += cache.read(base + 32, value) != sizeof(value) || value != 0x1234;
+  errors += cache.flush() != 0;  // Changed bytes went out when the line was evicted again
+  FRAM.read(base, value);
+  errors += value != 0xBEEF;
+  printResult("Cache<1,16> failures", 4, errors);
+}  // of function "cacheFailures()"
+void asyncDone(uint8_t *buffer, const uint32_t bytes) {
+  /*!
+   * @brief     Completion callback for the asynchronous transfers
+   * @param[in] buffer Buffer of the transfer, unused
+   * @param[in] bytes Number of bytes transferred
+   */
+  (void)buffer;
+  asyncDoneCount++;
+  asyncBytes += bytes;
+}  // of function "asyncDone()"
+void asyncTransfers(MB85_FRAM_Class &FRAM, const uint8_t block[], uint8_t readBack[]) {
+  /*!
+   * @brief     Fill all memory, write a block and read it back through the asynchronous queue
+   * @details   The time spent on the bus in each poll() call is measured, as that is the latency
+   *            the asynchronous interface adds to a main loop. A blocking read is made every few
+   *            polls to check that an interrupted read continues at the right address. Before the
+   *            queue is attached the transfers have to be refused.
+   * @param[in] FRAM Memory to use
+   * @param[in] block Data to write
+   * @param[out] readBack Buffer for the read
+   */
+  MB85_Transfer queue[MB85_ASYNC_QUEUE];  // Storage of the asynchronous queue
+  uint32_t      total   = FRAM.totalBytes();
+  uint32_t      address = total / 2 - BLOCK_SIZE / 2;  // Crosses a chip boundary in most layouts
+  uint32_t      errors  = FRAM.readAsync(address, readBack, BLOCK_SIZE) || FRAM.poll();
+  asyncDoneCount        = 0;
+  asyncBytes            = 0;
+  memset(readBack, 0, BLOCK_SIZE);
+  FRAM.attachQueue(queue, MB85_ASYNC_QUEUE);
+  FRAM.fillAsync(0, total, 0x5A, asyncDone);
+  FRAM.writeAsync(address, block, BLOCK_SIZE, asyncDone);
+  FRAM.readAsync(address, readBack, BLOCK_SIZE, asyncDone);
+  I2CStats stats   = {};
+  uint64_t longest = 0;  // Most bus clock cycles used by one poll()
+  uint32_t polls   = 0;
+  bool     busy    = true;
+  while (busy) {
+    Wire.resetStats();
+    busy = FRAM.poll();
+    polls++;
+    if (Wire.stats.clocks > longest) longest = Wire.stats.clocks;
+    addStats(stats);
+    if (polls % 97 == 0) {  // Blocking access in between, not counted
+      uint32_t value;
+      FRAM.read(total - 1000, value);
+    }  // of if-then time for a blocking read
+  }    // of while transfers pending
+  FRAM.attachQueue(nullptr, 0);
+  errors += asyncDoneCount != 3 || asyncBytes != total + 2 * BLOCK_SIZE;
+  for (uint16_t i = 0; i < BLOCK_SIZE; i++) errors += readBack[i] != block[i];
+  for (uint32_t i = 0; i < total; i += 997) {
+    uint8_t value = 0;
+    FRAM.read(i, value);
+    errors += (i < address || i >= address + BLOCK_SIZE) && value != 0x5A;
+  }  // of for-next sample of addresses
+  printResult("poll() fill/write/read", polls, errors, stats);
+  printf("%-24s %6u polls, longest %.0fus at 100kHz, %.0fus at 400kHz\n", "", polls,
+         longest * 1000000.0 / I2C_STANDARD_MODE, longest * 1000000.0 / I2C_FAST_MODE);
+}  // of function "asyncTransfers()"
+void runLayout(const Layout &layout) {
+  /*!
+   * @brief     Attach the chips of a layout to the simulated bus and run all benchmarks
+   * @param[in] layout Memory layout to simulate
+   */
+  static uint8_t  expected[SCALAR_CALLS * sizeof(uint32_t)];
+  static Record   records[STRUCT_CALLS];
+  static uint8_t  block[BLOCK_SIZE], readBack[BLOCK_SIZE];
+  MB85_FRAM_Class FRAM;  // Fresh instance for each layout
+  MB85_Type       types[MB85_MAX_DEVICES];
+  uint32_t        errors;
+  Wire.detachAll();
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    if (layout.bytes[i]) {
+      Wire.attachChip(MB85_MIN_ADDRESS + i, layout.bytes[i], layout.product[i]);
+    }  // of if-then chip present
+    types[i] = typeOf(layout.bytes[i]);
+  }  // of for-next each chip in the layout
+  printf("\nLayout %s\n", layout.name);
+
+  uint32_t checksum = memoryChecksum();  // begin() must leave the memory contents unchanged
+  Wire.resetStats();
+  uint8_t  chips = FRAM.begin(I2C_FAST_MODE);
+  uint32_t total = FRAM.totalBytes();
+  printf("Detected %u chips with %u bytes in total, begin() takes %.0fus at 400kHz\n\n", chips,
+         total, Wire.busMicros(I2C_FAST_MODE));
+  printHeader();
+  printResult("begin()", 1, checksum != memoryChecksum());
+  Wire.resetStats();
+  MB85_FRAM_Class known;
+  errors = known.begin(types, I2C_FAST_MODE) != chips || known.totalBytes() != total;
+  printResult("begin(layout)", 1, errors);
+  if (total < 2 * sizeof(Record)) return;
+
+  Wire.resetStats();  // Scattered 4 byte writes and reads
+  for (uint16_t i = 0; i < SCALAR_CALLS; i++) {
+    uint32_t value = 0;
+    for (uint8_t j = 0; j < sizeof(value); j++) {
+      expected[i * sizeof(value) + j] = nextRandom();
+      value |= (uint32_t)expected[i * sizeof(value) + j] << (8 * j);
+    }  // of for-next each byte
+    FRAM.write((i * 2477UL) % (total - sizeof(value)), value);
+  }  // of for-next each call
+  printResult("write(uint32_t)", SCALAR_CALLS, 0);
+  Wire.resetStats();
+  errors = 0;
+  for (uint16_t i = 0; i < SCALAR_CALLS; i++) {
+    uint32_t value = 0;
+    FRAM.read((i * 2477UL) % (total - sizeof(value)), value);
+    for (uint8_t j = 0; j < sizeof(value); j++) {
+      if ((uint8_t)(value >> (8 * j)) != expected[i * sizeof(value) + j]) errors++;
+    }  // of for-next each byte
+  }    // of for-next each call
+  printResult("read(uint32_t)", SCALAR_CALLS, errors);
+
+  Wire.resetStats();  // 100 byte structures, each needing several I2C buffers
+  for (uint16_t i = 0; i < STRUCT_CALLS; i++) {
+    for (uint8_t j = 0; j < sizeof(Record); j++) records[i].data[j] = nextRandom();
+    FRAM.write(i * sizeof(Record), records[i]);
+  }  // of for-next each call
+  printResult("write(Record[100])", STRUCT_CALLS, 0);
+  Wire.resetStats();
+  errors = 0;
+  for (uint16_t i = 0; i < STRUCT_CALLS; i++) {
+    Record record;
+    FRAM.read(i * sizeof(Record), record);
+    for (uint8_t j = 0; j < sizeof(Record); j++) errors += record.data[j] != records[i].data[j];
+  }  // of for-next each call
+  printResult("read(Record[100])", STRUCT_CALLS, errors);
+
+  if (total >= BLOCK_SIZE * 2) {  // Multi-kilobyte buffers through the block interface
+    Wire.resetStats();
+    for (uint16_t i = 0; i < BLOCK_CALLS; i++) {
+      for (uint16_t j = 0; j < BLOCK_SIZE; j++) block[j] = nextRandom();
+      FRAM.writeBlock(i * BLOCK_SIZE / 2, block, BLOCK_SIZE);
+    }  // of for-next each call
+    printResult("writeBlock(4096)", BLOCK_CALLS, 0);
+    Wire.resetStats();
+    errors = 0;
+    for (uint16_t i = 0; i < BLOCK_CALLS; i++) {
+      FRAM.readBlock((BLOCK_CALLS - 1) * BLOCK_SIZE / 2, readBack, BLOCK_SIZE);
+      for (uint16_t j = 0; j < BLOCK_SIZE; j++) errors += readBack[j] != block[j];
+    }  // of for-next each call
+    printResult("readBlock(4096)", BLOCK_CALLS, errors);
+    asyncTransfers(FRAM, block, readBack);
+  }  // of if-then enough memory for the blocks
+
+  uint16_t counters[FIELD_COUNT] = {0};  // Scattered 2 byte counter updates, direct and cached
+  Wire.resetStats();
+  for (uint16_t i = 0; i < FIELD_CALLS; i++) {
+    uint8_t field = nextRandom() % FIELD_COUNT;
+    FRAM.write(FIELD_BASE + field * FIELD_STRIDE, ++counters[field]);
+  }  // of for-next each update
+  printResult("write(uint16_t) fields", FIELD_CALLS, 0);
+  cachedFields<MB85_FRAM_Cache<>>(FRAM, counters, "Cache<4,16> fields");
+  cachedFields<MB85_FRAM_Cache<16, 32>>(FRAM, counters, "Cache<16,32> fields");
+  cacheFailures(FRAM);
+
+  if (chips > 1) {  // Structures split across the boundaries between chips
+    I2CStats writes = {}, reads = {};
+    errors          = 0;
+    Wire.resetStats();
+    for (uint16_t i = 0; i < CROSS_CALLS; i++) {
+      Record   record;
+      uint32_t address = 0;  // Start of the next chip in turn
+      for (uint8_t j = 0; j <= i % (chips - 1); j++) address += FRAM.memSize(j);
+      address -= sizeof(Record) / 2 + i;
+      for (uint8_t j = 0; j < sizeof(Record); j++) records[0].data[j] = nextRandom();
+      FRAM.write(address, records[0]);
+      addStats(writes);
+      FRAM.read(address, record);
+      addStats(reads);
+      for (uint8_t j = 0; j < sizeof(Record); j++) errors += record.data[j] != records[0].data[j];
+    }  // of for-next each call
+    printResult("write(Record) cross-chip", CROSS_CALLS, 0, writes);
+    printResult("read(Record) cross-chip", CROSS_CALLS, errors, reads);
+  }  // of if-then more than one chip
+
+  Wire.resetStats();  // Fill all memory with a 4 byte pattern
+  uint32_t pattern = 0xA5C3E10F;
+  FRAM.fillMemory(pattern);
+  printResult("fillMemory(uint32_t)", 1, 0);
+  errors = 0;
+  for (uint32_t i = 0; i + sizeof(pattern) <= total; i += 997 * sizeof(pattern)) {
+    uint32_t value = 0;
+    FRAM.read(i, value);
+    errors += value != pattern;
+  }  // of for-next sample of addresses
+  if (errors) printf("fillMemory(): %u mismatched samples\n", errors);
+  totalErrors += errors;
+}  // of function "runLayout()"
+void attachLayout(TwoWire &bus, const Layout &layout) {
+  /*!
+   * @brief     Attach the chips of a layout to a simulated bus
+   * @param[in] bus Bus to attach to
+   * @param[in] layout Memory layout to simulate
+   */
+  bus.detachAll();
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    if (layout.bytes[i]) bus.attachChip(MB85_MIN_ADDRESS + i, layout.bytes[i], layout.product[i]);
+  }  // of for-next each chip in the layout
+}  // of function "attachLayout()"
+void printBuses(const char *mapping, const char *operation, const uint32_t bytes,
+                const uint32_t errors) {
+  /*!
+   * @brief     Print one result line for a multi-bus operation and clear the bus counters
+   * @details   The buses run at the same time, so the wall time is that of the busiest bus
+   * @param[in] mapping Name of the memory mapping
+   * @param[in] operation Name of the operation
+   * @param[in] bytes Number of payload bytes transferred
+   * @param[in] errors Number of mismatched bytes
+   */
+  double wire  = Wire.busMicros(I2C_FAST_MODE);
+  double wire1 = Wire1.busMicros(I2C_FAST_MODE);
+  double wall  = wire > wire1 ? wire : wire1;
+  printf("%-10s %-18s %7u %9.0f %9.0f %9.0f %7.2f %9.0f %5u\n", mapping, operation, bytes, wire,
+         wire1, wall, wall > 0 ? (wire + wire1) / wall : 0.0, wall > 0 ? bytes / wall * 1e6 : 0.0,
+         errors + Wire.stats.dropped + Wire1.stats.dropped);
+  totalErrors += errors + Wire.stats.dropped + Wire1.stats.dropped;
+  Wire.resetStats();
+  Wire1.resetStats();
+}  // of function "printBuses()"
+void runBuses(const BusLayout &layout) {
+  /*!
+   * @brief     Attach the chips of a layout to both simulated buses and compare the mappings
+   * @details   A block spanning the middle of the memory is written and read back and then all
+   *            memory is filled through the asynchronous queue. With the contiguous mapping the
+   *            block is split between the buses only where it crosses from one bus to the next,
+   *            with the striped mapping every transfer of more than 256 bytes uses both buses.
+   *            A striped compare() has to report a failure on one bus as such even when the other
+   *            bus has already found a difference further on.
+   * @param[in] layout Memory layout to simulate
+   */
+  static uint8_t block[BUS_BLOCK_SIZE], readBack[BUS_BLOCK_SIZE];
+  const char    *names[] = {"contiguous", "striped"};
+  attachLayout(Wire, layout.bus[0]);
+  attachLayout(Wire1, layout.bus[1]);
+  Wire.resetStats();
+  Wire1.resetStats();
+  printf("\nLayout %s\n\n", layout.name);
+  printf("%-10s %-18s %7s %9s %9s %9s %7s %9s %5s\n", "Mapping", "Operation", "Bytes", "Wire us",
+         "Wire1 us", "Wall us", "Speedup", "B/s", "Err");
+  for (uint8_t m = MB85_CONTIGUOUS; m <= MB85_STRIPED; m++) {
+    MB85_FRAM_Class FRAM(Wire, Wire1);
+    MB85_Transfer   queue[1];  // A single asynchronous transfer at a time
+    uint8_t         chips = FRAM.begin(I2C_FAST_MODE, (MB85_Mapping)m);
+    uint32_t        total = FRAM.totalBytes();
+    FRAM.attachQueue(queue, 1);
+    printBuses(names[m], "begin()", 0, chips == 0);
+    uint32_t address = total / 2 - BUS_BLOCK_SIZE / 2;
+    for (uint16_t i = 0; i < BUS_BLOCK_SIZE; i++) block[i] = nextRandom();
+    FRAM.writeBlock(address, block, BUS_BLOCK_SIZE);
+    printBuses(names[m], "writeBlock(16384)", BUS_BLOCK_SIZE, 0);
+    uint32_t errors = FRAM.readBlock(address, readBack, BUS_BLOCK_SIZE) != BUS_BLOCK_SIZE;
+    for (uint16_t i = 0; i < BUS_BLOCK_SIZE; i++) errors += readBack[i] != block[i];
+    printBuses(names[m], "readBlock(16384)", BUS_BLOCK_SIZE, errors);
+    if (m == MB85_STRIPED) {  // Bus 0 fails on its last chunk of the first stripe, after bus 1
+      uint32_t differs = 2 * MB85_STRIPE_SIZE - 2 * BUFFER_LENGTH;  // found a later difference
+      FRAM.readBlock(0, readBack, BUS_BLOCK_SIZE);
+      readBack[differs] ^= 0x01;
+      errors = FRAM.compare(0, readBack, BUS_BLOCK_SIZE) != differs;
+      FRAM.setRetries(0);
+      Wire.resetStats();
+      Wire1.resetStats();
+      Wire.injectNaks(MB85_STRIPE_SIZE / BUFFER_LENGTH + 1);
+      errors += FRAM.compare(0, readBack, BUS_BLOCK_SIZE) != MB85_COMPARE_FAILED;
+      Wire.injectNaks(0);
+      FRAM.setRetries(MB85_RETRIES);
+      printBuses(names[m], "compare() failure", 0, errors);
+    }  // of if-then striped
+    FRAM.fillAsync(0, total, 0x3C);
+    while (FRAM.poll()) continue;  // Both buses work on the fill
+    printBuses(names[m], "poll() fill", total, 0);
+    errors = 0;
+    for (uint32_t i = 0; i < total; i += 251) {
+      uint8_t value = 0;
+      FRAM.read(i, value);
+      errors += value != 0x3C;
+    }  // of for-next sample of addresses
+    Wire.resetStats();
+    Wire1.resetStats();
+    if (errors) printf("fillAsync(): %u mismatched samples\n", errors);
+    totalErrors += errors;
+  }  // of for-next each mapping
+}  // of function "runBuses()"
+void runDetection(const Layout &layout, const Contents contents) {
+  /*!
+   * @brief     Check that begin() finds the memories of a layout and leaves their contents alone
+   * @details   With all memories cleared to 0 the detection can't rely on different contents, and
+   *            with every byte holding the low byte of its address a read from the wrong address
+   *            returns the value the detection wrote
+   * @param[in] layout Memory layout to simulate
+   * @param[in] contents Memory contents before calling begin()
+   */
+  static uint8_t  block[SIM_MAX_CHIPS * 131072UL], readBack[SIM_MAX_CHIPS * 131072UL];
+  MB85_FRAM_Class FRAM;
+  uint32_t        expected = 0, errors = 0;
+  uint8_t         chips    = 0;
+  attachLayout(Wire, layout);
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    uint32_t bytes  = 0;
+    uint8_t *memory = Wire.chipMemory(MB85_MIN_ADDRESS + i, &bytes);
+    for (uint32_t j = 0; memory != nullptr && contents != RANDOM && j < bytes; j++) {
+      memory[j] = contents == ZEROED ? 0 : (uint8_t)j;
+    }  // of for-next each byte
+    if (layout.bytes[i] == 0) continue;
+    expected += layout.bytes[i];
+    chips++;
+  }  // of for-next each chip in the layout
+  uint32_t checksum = memoryChecksum();
+  Wire.resetStats();
+  errors += FRAM.begin(I2C_FAST_MODE) != chips || FRAM.totalBytes() != expected;
+  double micros = Wire.busMicros(I2C_FAST_MODE);
+  errors += checksum != memoryChecksum();
+  for (uint8_t i = 0, chip = 0; i < SIM_MAX_CHIPS; i++) {
+    if (layout.bytes[i]) errors += FRAM.memSize(chip++) != layout.bytes[i];
+  }  // of for-next each chip in the layout
+  Wire.resetStats();
+  FRAM.write(0, checksum);  // Address bytes needed by the first memory
+  double addressBytes = Wire.stats.addressBytes;
+  for (uint32_t i = 0; i < expected; i++) block[i] = nextRandom();
+  FRAM.writeBlock(0, block, expected);
+  FRAM.readBlock(0, readBack, expected);
+  for (uint32_t i = 0; i < expected; i++) errors += readBack[i] != block[i];
+  for (uint8_t i = 0, chip = 0; i < SIM_MAX_CHIPS; i++) {  // Check each memory got its own part
+    const uint8_t *memory = Wire.chipMemory(MB85_MIN_ADDRESS + i);
+    if (layout.bytes[i] == 0) continue;
+    uint32_t start = 0;
+    for (uint8_t j = 0; j < chip; j++) start += FRAM.memSize(j);
+    errors += memcmp(memory, block + start, layout.bytes[i]) != 0;
+    chip++;
+  }  // of for-next each chip in the layout
+  printf("%-40s %-8s %5u %7u %9.0f %8.0f %5u\n", layout.name, CONTENTS[contents], chips,
+         expected, micros, addressBytes, errors + Wire.stats.dropped);
+  totalErrors += errors + Wire.stats.dropped;
+}  // of function "runDetection()"
+template <typename FRAM_TYPE>
+uint32_t timedScalars(FRAM_TYPE &FRAM, const uint32_t total, const bool writing,
+                      double &nsPerCall) {
+  /*!
+   * @brief     Write or read and check FIXED_CALLS scattered uint32_t values and time the calls
+   * @details   The values are aligned and derived from the address, so any class can check the
+   *            values written by any other class with the same layout
+   * @param[in] FRAM Instance of MB85_FRAM_Class or MB85_FRAM_Fixed
+   * @param[in] total Total memory size in bytes
+   * @param[in] writing Write the values when true, otherwise read and check them
+   * @param[out] nsPerCall CPU time per call in nanoseconds
+   * @return    Number of mismatched values
+   */
+  uint32_t errors = 0;
+  uint32_t start  = micros();
+  for (uint16_t i = 0; i < FIXED_CALLS; i++) {
+    uint32_t address = (i * 2477UL) % (total / sizeof(uint32_t)) * sizeof(uint32_t);
+    uint32_t value   = address * 2654435761UL;
+    if (writing) {
+      FRAM.write(address, value);
+    } else {
+      uint32_t readBack = 0;
+      FRAM.read(address, readBack);
+      errors += readBack != value;
+    }  // of if-then-else writing
+  }    // of for-next each call
+  nsPerCall = (micros() - start) * 1000.0 / FIXED_CALLS;
+  return errors;
+}  // of function "timedScalars()"
+void printFixed(const char *name, const char *operation, const size_t ram, const double nsPerCall,
+                const uint32_t errors) {
+  /*!
+   * @brief     Print one result line comparing the dynamic and the compile-time classes
+   * @param[in] name Name of the class
+   * @param[in] operation Name of the operation
+   * @param[in] ram Size of an instance in bytes
+   * @param[in] nsPerCall CPU time per call in nanoseconds
+   * @param[in] errors Number of mismatched values
+   */
+  printf("%-16s %-24s %6u %8.0f %8.2f %5u\n", name, operation, (unsigned)ram, nsPerCall,
+         (double)Wire.stats.transactions / FIXED_CALLS, errors + Wire.stats.dropped);
+  totalErrors += errors + Wire.stats.dropped;
+  Wire.resetStats();
+}  // of function "printFixed()"
+template <typename FIXED>
+void runFixed(const Layout &layout) {
+  /*!
+   * @brief     Compare MB85_FRAM_Class with an MB85_FRAM_Fixed instance for the same layout
+   * @details   Each class reads back the values written by the other one, which checks that both
+   *            map the memory addresses onto the chips in the same way
+   * @tparam    FIXED MB85_FRAM_Fixed specialisation matching the layout
+   * @param[in] layout Memory layout to simulate
+   */
+  MB85_FRAM_Class FRAM;
+  FIXED           fixed;
+  MB85_Type       types[MB85_MAX_DEVICES];
+  double          ns;
+  attachLayout(Wire, layout);
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) types[i] = typeOf(layout.bytes[i]);
+  FRAM.begin(types, I2C_FAST_MODE);
+  fixed.begin(I2C_FAST_MODE);
+  uint32_t total = FRAM.totalBytes();
+  printf("\nLayout %s\n\n", layout.name);
+  printf("%-16s %-24s %6s %8s %8s %5s\n", "Class", "Operation", "RAM", "ns/op", "Trans/op", "Err");
+  Wire.resetStats();
+  uint32_t errors = timedScalars(FRAM, total, true, ns) + (fixed.totalBytes() != total);
+  printFixed("MB85_FRAM_Class", "write(uint32_t)", sizeof(FRAM), ns, errors);
+  errors = timedScalars(fixed, total, false, ns);
+  printFixed("MB85_FRAM_Fixed", "read(uint32_t)", sizeof(fixed), ns, errors);
+  errors = timedScalars(fixed, total, true, ns);
+  printFixed("MB85_FRAM_Fixed", "write(uint32_t)", sizeof(fixed), ns, errors);
+  errors = timedScalars(FRAM, total, false, ns);
+  printFixed("MB85_FRAM_Class", "read(uint32_t)", sizeof(FRAM), ns, errors);
+}  // of function "runFixed()"
+void attachSpiLayout(const SpiLayout &layout) {
+  /*!
+   * @brief     Attach the chips of a layout to the simulated SPI bus
+   * @param[in] layout Memory layout to simulate
+   */
+  SPI.detachAll();
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {
+    if (layout.bytes[i]) SPI.attachChip(SPI_CS_PINS[i], layout.bytes[i], layout.product[i]);
+  }  // of for-next each chip in the layout
+}  // of function "attachSpiLayout()"
+void runSpiDetection(const SpiLayout &layout) {
+  /*!
+   * @brief     Check that begin() finds the SPI memories of a layout by their RDID response
+   * @details   Memories without RDID can't be found and are expected to be skipped
+   * @param[in] layout Memory layout to simulate
+   */
+  static uint8_t      block[1UL << 20], readBack[1UL << 20];
+  MB85_FRAM_SPI_Class FRAM(SPI, SPI_CS_PINS, SIM_SPI_CHIPS);
+  uint32_t            expected = 0, errors = 0;
+  uint8_t             chips    = 0;
+  attachSpiLayout(layout);
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {
+    if (layout.product[i] == 0) continue;
+    expected += layout.bytes[i];
+    chips++;
+  }  // of for-next each chip in the layout
+  SPI.resetStats();
+  errors += FRAM.begin() != chips || FRAM.totalBytes() != expected;
+  double micros = SPI.busMicros(MB85_SPI_CLOCK);
+  for (uint8_t i = 0, chip = 0; i < SIM_SPI_CHIPS; i++) {
+    if (layout.product[i]) errors += FRAM.memSize(chip++) != layout.bytes[i];
+  }  // of for-next each chip in the layout
+  for (uint32_t i = 0; i < expected; i++) block[i] = nextRandom();
+  FRAM.writeBlock(0, block, expected);
+  FRAM.readBlock(0, readBack, expected);
+  for (uint32_t i = 0; i < expected; i++) errors += readBack[i] != block[i];
+  uint32_t start = 0;  // Start of the memory in the block
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {  // Check each memory got its own part
+    if (layout.product[i] == 0) continue;
+    errors += memcmp(SPI.chipMemory(SPI_CS_PINS[i]), block + start, layout.bytes[i]) != 0;
+    start += layout.bytes[i];
+  }  // of for-next each chip in the layout
+  printf("%-46s %5u %7u %9.1f %5u\n", layout.name, chips, expected, micros, errors);
+  totalErrors += errors;
+}  // of function "runSpiDetection()"
+BusResult takeResult(const bool spi, const uint32_t calls, const uint32_t errors) {
+  /*!
+   * @brief     Return the bus counters of one operation and clear the counters of both buses
+   * @param[in] spi Take the counters of the SPI bus, otherwise those of "Wire"
+   * @param[in] calls Number of library calls made
+   * @param[in] errors Number of mismatched bytes
+   * @return    Counters of the operation
+   */
+  BusResult result = {calls, Wire.stats.transactions, Wire.stats.addressBytes,
+                      Wire.stats.payloadBytes, errors + Wire.stats.dropped, Wire.stats.clocks};
+  if (spi) {
+    result = {calls,  SPI.stats.transactions, SPI.stats.commandBytes, SPI.stats.payloadBytes,
+              errors, SPI.stats.clocks};
+  }  // of if-then SPI bus
+  Wire.resetStats();
+  SPI.resetStats();
+  return result;
+}  // of function "takeResult()"
+uint8_t blockByte(const uint16_t block, const uint16_t index) {
+  /*!
+   * @brief     Return a byte of a repeatable test block, so that blocks needn't be stored
+   * @param[in] block Block number
+   * @param[in] index Byte index in the block
+   * @return    Byte value
+   */
+  return (uint8_t)(index * 7 + block * 13 + (index >> 8));
+}  // of function "blockByte()"
+void compareOps(MB85_FRAM_Class &FRAM, const bool spi, BusResult results[COMPARE_OPS]) {
+  /*!
+   * @brief      Run the operations compared between I2C and SPI and check the data read back
+   * @param[in]  FRAM Instance with the memories already found
+   * @param[in]  spi The memories are on the SPI bus, otherwise on "Wire"
+   * @param[out] results Bus counters of each of the COMPARE_NAMES operations
+   */
+  static uint8_t block[BLOCK_SIZE];
+  uint32_t       total  = FRAM.totalBytes();
+  uint32_t       errors = 0;
+  takeResult(spi, 0, 0);  // Clear the counters
+  for (uint16_t i = 0; i < SCALAR_CALLS; i++) {
+    uint32_t address = (i * 2477UL) % (total / sizeof(uint32_t)) * sizeof(uint32_t);
+    FRAM.write(address, (uint32_t)(address * 2654435761UL));
+  }  // of for-next each call
+  results[0] = takeResult(spi, SCALAR_CALLS, 0);
+  for (uint16_t i = 0; i < SCALAR_CALLS; i++) {
+    uint32_t address = (i * 2477UL) % (total / sizeof(uint32_t)) * sizeof(uint32_t);
+    uint32_t value   = 0;
+    FRAM.read(address, value);
+    errors += value != (uint32_t)(address * 2654435761UL);
+  }  // of for-next each call
+  results[1] = takeResult(spi, SCALAR_CALLS, errors);
+  for (uint16_t b = 0; b < BLOCK_CALLS; b++) {  // Blocks cross from one memory to the next
+    for (uint16_t i = 0; i < BLOCK_SIZE; i++) block[i] = blockByte(b, i);
+    FRAM.writeBlock(b * (total / BLOCK_CALLS) + 1000, block, BLOCK_SIZE);
+  }  // of for-next each block
+  results[2] = takeResult(spi, BLOCK_CALLS, 0);
+  errors     = 0;
+  for (uint16_t b = 0; b < BLOCK_CALLS; b++) {
+    errors += FRAM.readBlock(b * (total / BLOCK_CALLS) + 1000, block, BLOCK_SIZE) != BLOCK_SIZE;
+    for (uint16_t i = 0; i < BLOCK_SIZE; i++) errors += block[i] != blockByte(b, i);
+  }  // of for-next each block
+  results[3] = takeResult(spi, BLOCK_CALLS, errors);
+  MB85_Transfer queue[1];  // A single asynchronous transfer at a time
+  FRAM.attachQueue(queue, 1);
+  FRAM.fillAsync(0, total, 0xA5);
+  uint32_t polls = 0;
+  while (FRAM.poll()) polls++;  // The poll() calls are the calls of interest here
+  FRAM.attachQueue(nullptr, 0);
+  errors = 0;
+  for (uint32_t i = 0; i < total; i += 251) {
+    uint8_t value = 0;
+    FRAM.read(i, value);
+    errors += value != 0xA5;
+  }  // of for-next sample of addresses
+  results[4] = takeResult(spi, polls, errors);
+}  // of function "compareOps()"
+void printCompare(const char *operation, const char *bus, const BusResult &result,
+                  const uint32_t clock, const double baseline) {
+  /*!
+   * @brief     Print one result line comparing I2C and SPI
+   * @param[in] operation Name of the operation
+   * @param[in] bus Name of the bus and its clock
+   * @param[in] result Counters of the operation
+   * @param[in] clock Bus clock in Hz
+   * @param[in] baseline Bytes per second of the same operation on I2C, 0 for the I2C line
+   */
+  double seconds = (double)result.clocks / clock;
+  double rate    = seconds > 0 ? result.payloadBytes / seconds : 0.0;
+  printf("%-18s %-10s %6u %8.2f %8.2f %8.2f %10.0f %7.1f %5u\n", operation, bus, result.calls,
+         (double)result.transactions / result.calls, (double)result.commandBytes / result.calls,
+         (double)result.payloadBytes / result.calls, rate, baseline > 0 ? rate / baseline : 1.0,
+         result.errors);
+  totalErrors += result.errors;
+}  // of function "printCompare()"
+void runSpiCompare() {
+  /*!
+   * @brief     Compare four MB85RC256V on I2C at 1MHz with four MB85RS256B on SPI
+   * @details   The same operations are run on both buses and the payload throughput is given in
+   *            bytes per second of bus time, the time the MCU spends between bytes isn't included
+   */
+  const Layout    i2c    = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  const SpiLayout spi    = SPI_LAYOUTS[0];
+  const char     *names[SPI_CLOCK_COUNT] = {"SPI 20MHz", "SPI 40MHz"};
+  BusResult       base[COMPARE_OPS], fast[SPI_CLOCK_COUNT][COMPARE_OPS];
+  attachLayout(Wire, i2c);
+  MB85_FRAM_Class FRAM;
+  FRAM.begin(I2C_FAST_MODE_PLUS_MODE);
+  compareOps(FRAM, false, base);
+  for (uint8_t c = 0; c < SPI_CLOCK_COUNT; c++) {
+    attachSpiLayout(spi);
+    MB85_FRAM_SPI_Class spiFRAM(SPI, SPI_CS_PINS, SIM_SPI_CHIPS, SPI_CLOCKS[c]);
+    if (spiFRAM.begin() != 4) totalErrors++;
+    compareOps(spiFRAM, true, fast[c]);
+  }  // of for-next each SPI clock
+  printf("%-18s %-10s %6s %8s %8s %8s %10s %7s %5s\n", "Operation", "Bus", "Calls", "Trans/op",
+         "Cmd/op", "Data/op", "B/s", "Speedup", "Err");
+  for (uint8_t i = 0; i < COMPARE_OPS; i++) {
+    double seconds  = (double)base[i].clocks / I2C_FAST_MODE_PLUS_MODE;
+    double baseline = seconds > 0 ? base[i].payloadBytes / seconds : 0.0;
+    printCompare(COMPARE_NAMES[i], "I2C 1MHz", base[i], I2C_FAST_MODE_PLUS_MODE, 0);
+    for (uint8_t c = 0; c < SPI_CLOCK_COUNT; c++) {
+      printCompare(COMPARE_NAMES[i], names[c], fast[c][i], SPI_CLOCKS[c], baseline);
+    }  // of for-next each SPI clock
+  }    // of for-next each operation
+}  // of function "runSpiCompare()"
+void memoryImage(const bool spi, uint8_t image[]) {
+  /*!
+   * @brief      Copy the contents of all simulated memories into one linear image
+   * @param[in]  spi Use the memories on the SPI bus, otherwise those on "Wire"
+   * @param[out] image Memory contents in address order
+   */
+  uint32_t start = 0;  // Start of the memory in the image
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    uint32_t       bytes  = 0;
+    const uint8_t *memory = spi ? SPI.chipMemory(SPI_CS_PINS[i], &bytes)
+                                : Wire.chipMemory(MB85_MIN_ADDRESS + i, &bytes);
+    if (memory != nullptr) memcpy(image + start, memory, bytes);
+    start += bytes;
+  }  // of for-next each chip
+}  // of function "memoryImage()"
+void printPrimitive(const char *operation, const uint32_t payload, const BusResult &result,
+                    const uint32_t clock, const uint8_t byteClocks) {
+  /*!
+   * @brief     Print one result line for the memory primitives
+   * @details   The ideal time is that of the payload bytes alone, without any addressing
+   * @param[in] operation Name of the operation
+   * @param[in] payload Bytes which have to cross the bus, twice the length for a copy
+   * @param[in] result Counters of the operation
+   * @param[in] clock Bus clock in Hz
+   * @param[in] byteClocks Clock cycles per byte on the bus
+   */
+  double busMs   = result.clocks * 1000.0 / clock;
+  double idealMs = (double)payload * byteClocks * 1000.0 / clock;
+  printf("%-26s %7u %8u %9.1f %9.1f %6.1f %5u\n", operation, payload, result.transactions, busMs,
+         idealMs, busMs > 0 ? 100.0 * idealMs / busMs : 0.0, result.errors);
+  totalErrors += result.errors;
+}  // of function "printPrimitive()"
+void runPrimitives(MB85_FRAM_Class &FRAM, const bool spi, const uint32_t clock) {
+  /*!
+   * @brief     Measure fill(), copy() and compare() against a byte-by-byte fill and check the data
+   * @details   The same operations are applied to a reference image in RAM, which has to match
+   *            the simulated memories after each operation
+   * @param[in] FRAM Instance with the memories already found
+   * @param[in] spi The memories are on the SPI bus, otherwise on "Wire"
+   * @param[in] clock Bus clock in Hz
+   */
+  static uint8_t expected[1UL << 20], image[1UL << 20];
+  const uint8_t  pattern[] = {0x12, 0x34, 0x56};
+  const uint8_t  clocks    = spi ? 8 : 9;  // Clocks per byte, I2C adds the acknowledge bit
+  uint32_t       total     = FRAM.totalBytes();
+  uint32_t       half      = total / 2;
+  printf("%-26s %7s %8s %9s %9s %6s %5s\n", "Operation", "Bytes", "Trans", "Bus ms", "Ideal ms",
+         "Eff%", "Err");
+  takeResult(spi, 0, 0);  // Clear the counters
+  uint32_t errors = 0;
+  for (uint32_t i = 0; i < total; i++) errors += FRAM.write(i, (uint8_t)0x5A) != 1;
+  memset(expected, 0x5A, total);
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("write(uint8_t) per byte", total, takeResult(spi, total, errors), clock, clocks);
+  errors = FRAM.fill(0, total, 0xC3) != total;
+  memset(expected, 0xC3, total);
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("fill(0xC3)", total, takeResult(spi, 1, errors), clock, clocks);
+  errors = FRAM.fill(7, total - 8, pattern, sizeof(pattern)) != total - 8;
+  for (uint32_t i = 0; i < total - 8; i++) expected[7 + i] = pattern[i % sizeof(pattern)];
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("fill(3 byte pattern)", total - 8, takeResult(spi, 1, errors), clock, clocks);
+  errors = FRAM.fillMemory((uint16_t)0xBEEF) != total / 2;
+  for (uint32_t i = 0; i < total; i += 2) expected[i] = 0xEF, expected[i + 1] = 0xBE;
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("fillMemory(uint16_t)", total, takeResult(spi, 1, errors), clock, clocks);
+  for (uint32_t i = 0; i < total; i++) expected[i] = nextRandom();
+  FRAM.writeBlock(0, expected, total);
+  takeResult(spi, 0, 0);
+  errors = FRAM.copy(0, half, half) != half;  // Move the first half of memory to the second
+  memcpy(expected + half, expected, half);
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("copy() half of memory", 2 * half, takeResult(spi, 1, errors), clock, clocks);
+  uint32_t length = 3 * total / 8;  // Overlapping ranges crossing a memory boundary
+  errors          = FRAM.copy(1000, 1037, length) != length;
+  memmove(expected + 1037, expected + 1000, length);
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("copy() overlap backwards", 2 * length, takeResult(spi, 1, errors), clock, clocks);
+  errors = FRAM.copy(total - 5000, total - 5037, 4900) != 4900;
+  memmove(expected + total - 5037, expected + total - 5000, 4900);
+  memoryImage(spi, image);
+  errors += memcmp(image, expected, total) != 0;
+  printPrimitive("copy() overlap forwards", 2 * 4900, takeResult(spi, 1, errors), clock, clocks);
+  errors = FRAM.compare(0, expected, total) != total;
+  printPrimitive("compare() equal", total, takeResult(spi, 1, errors), clock, clocks);
+  expected[half + 4321] ^= 0x01;  // Difference on the third memory
+  errors = FRAM.compare(0, expected, total) != half + 4321;
+  expected[half + 4321] ^= 0x01;
+  printPrimitive("compare() 1 difference", half + 4321, takeResult(spi, 1, errors), clock, clocks);
+  if (!spi) {  // A memory not responding must not look like a difference
+    FRAM.setRetries(0);
+    Wire.injectNaks(50);
+    errors = FRAM.compare(0, expected, total) != MB85_COMPARE_FAILED || FRAM.status() == 0;
+    Wire.injectNaks(0);
+    FRAM.setRetries(MB85_RETRIES);
+    uint32_t compared = Wire.stats.payloadBytes;
+    printPrimitive("compare() bus failure", compared, takeResult(spi, 1, errors), clock, clocks);
+  }  // of if-then I2C memories
+}  // of function "runPrimitives()"
+uint16_t logRecord(const uint32_t number, uint8_t record[]) {
+  /*!
+   * @brief      Build a repeatable ring log record from its number
+   * @param[in]  number Record number
+   * @param[out] record Record bytes, up to 47
+   * @return     Record length, 8 to 47 bytes
+   */
+  uint16_t length = 8 + number * 7 % 40;
+  for (uint16_t i = 0; i < length; i++) record[i] = (uint8_t)(number * 31 + i);
+  return length;
+}  // of function "logRecord()"
+uint32_t checkLog(MB85_FRAM_RingLog &log, uint32_t &reads) {
+  /*!
+   * @brief      Read the whole ring log and check every record against its number
+   * @param[in]  log Ring log to check
+   * @param[out] reads Number of records read
+   * @return     Number of bad records
+   */
+  uint8_t  record[64], expected[64];
+  uint32_t errors = 0, cursor = log.oldest();
+  for (reads = 0; reads < log.records(); reads++) {
+    uint16_t length = logRecord(log.firstRecord() + reads, expected);
+    errors += log.readNext(cursor, record, sizeof(record)) != length ||
+              memcmp(record, expected, length) != 0;
+  }  // of for-next each record
+  return errors;
+}  // of function "checkLog()"
+void printStructure(const char *operation, const uint32_t calls, const uint32_t errors) {
+  /*!
+   * @brief     Print one result line for a data structure and clear the bus counters
+   * @param[in] operation Name of the operation
+   * @param[in] calls Number of library calls made
+   * @param[in] errors Number of bad records or states
+   */
+  printf("%-28s %6u %8.2f %8.2f %9.1f %5u\n", operation, calls,
+         (double)Wire.stats.transactions / calls, (double)Wire.stats.payloadBytes / calls,
+         Wire.busMicros(I2C_FAST_MODE) / calls, errors + Wire.stats.dropped);
+  totalErrors += errors + Wire.stats.dropped;
+  Wire.resetStats();
+}  // of function "printStructure()"
+void runRingLog() {
+  /*!
+   * @brief     Append to, recover and read a ring log which crosses a memory boundary
+   * @details   The records are built from their number, so the log contents can be checked after
+   *            any number of dropped records. A power failure is simulated by damaging the header
+   *            copy written last, after which begin() has to fall back to the state before the
+   *            last append. Appends and pops on a full log whose reads or header write fail have
+   *            to leave the log in RAM and in the memory as it was.
+   */
+  const Layout      layout = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  uint8_t           record[64];
+  const void       *records[LOG_BATCH];
+  uint16_t          lengths[LOG_BATCH];
+  uint8_t           batch[LOG_BATCH][64];
+  uint32_t          reads = 0, errors = 0, number = 0;
+  MB85_FRAM_Class   FRAM;
+  MB85_FRAM_RingLog log(FRAM, LOG_START, LOG_SIZE);
+  attachLayout(Wire, layout);
+  FRAM.begin(I2C_FAST_MODE);
+  Wire.resetStats();
+  printf("%-28s %6s %8s %8s %9s %5s\n", "Operation", "Calls", "Trans/op", "Data/op", "Bus us/op",
+         "Err");
+  printStructure("begin() format", 1, !log.begin(true) || log.records() != 0);
+  for (uint16_t i = 0; i < LOG_CALLS; i++) {
+    uint16_t length = logRecord(number++, record);
+    errors += !log.append(record, length);
+  }  // of for-next each append
+  printStructure("append() 8-47 bytes", LOG_CALLS, errors);
+  errors = 0;
+  for (uint16_t i = 0; i < LOG_CALLS / LOG_BATCH; i++) {
+    for (uint8_t j = 0; j < LOG_BATCH; j++) {
+      lengths[j] = logRecord(number++, batch[j]);
+      records[j] = batch[j];
+    }  // of for-next each record in the batch
+    errors += !log.append(records, lengths, LOG_BATCH);
+  }  // of for-next each batch
+  printStructure("append() batch of 8", LOG_CALLS / LOG_BATCH, errors);
+  errors = log.firstRecord() + log.records() != number;
+  MB85_FRAM_RingLog recovered(FRAM, LOG_START, LOG_SIZE);
+  errors += !recovered.begin() || recovered.records() != log.records() ||
+            recovered.firstRecord() != log.firstRecord();
+  printStructure("begin() recovery", 1, errors);
+  errors = checkLog(recovered, reads);
+  printStructure("readNext() whole log", reads, errors + (reads == 0));
+  errors = 0;
+  for (uint16_t i = 0; i < 100; i++) {
+    uint16_t length = logRecord(recovered.firstRecord(), batch[0]);
+    errors += recovered.pop(record, sizeof(record)) != length || memcmp(record, batch[0], length);
+  }  // of for-next each record removed
+  printStructure("pop()", 100, errors);
+  uint32_t before = recovered.records(), first = recovered.firstRecord();
+  uint16_t length = logRecord(first + before, record);
+  recovered.append(record, length);
+  MB85_LogHeader copy[2];  // Damage the header copy written last
+  FRAM.read(LOG_START, copy[0]);
+  FRAM.read(LOG_START + sizeof(MB85_LogHeader), copy[1]);
+  uint8_t newest = (int32_t)(copy[1].sequence - copy[0].sequence) > 0 ? 1 : 0;
+  FRAM.write(LOG_START + newest * sizeof(MB85_LogHeader) + offsetof(MB85_LogHeader, crc),
+             (uint16_t)(copy[newest].crc ^ 0x0001));
+  Wire.resetStats();
+  MB85_FRAM_RingLog damaged(FRAM, LOG_START, LOG_SIZE);
+  errors = !damaged.begin() || damaged.records() != before || damaged.firstRecord() != first;
+  printStructure("begin() after power failure", 1, errors);
+  errors = checkLog(damaged, reads);
+  printStructure("readNext() after failure", reads, errors);
+  MB85_FRAM_RingLog full(FRAM, LOG_START, LOG_SIZE, false);  // Refuse appends when full
+  errors = !full.begin() || full.append(record, (uint16_t)(full.freeBytes() - 1)) ||
+           !full.append(record, 0) || full.records() != before + 1;
+  printStructure("append() without overwrite", 2, errors);
+  MB85_FRAM_RingLog failing(FRAM, LOG_START, LOG_SIZE);  // Full log, memory failing on demand
+  errors = !failing.begin(true);
+  for (number = 0; failing.freeBytes() >= sizeof(record); number++) {
+    errors += !failing.append(record, logRecord(number, record));
+  }  // of for-next until the log is full
+  const char    *names[] = {"append() failing drop", "pop() failing read", "pop() failing write"};
+  const uint32_t naks[]  = {1, 1, 3};  // The header is the third transaction of a pop()
+  I2CStats       failed  = {};         // Bus use of the failing call only
+  FRAM.setRetries(0);
+  for (uint8_t i = 0; i < 3; i++) {  // Dropping a record, popping it and writing its header fail
+    uint32_t used = failing.usedBytes(), records = failing.records(), head = failing.oldest();
+    Wire.injectNaks(naks[i]);
+    Wire.resetStats();
+    errors += i == 0 ? failing.append(record, (uint16_t)failing.freeBytes()) : failing.pop() != 0;
+    addStats(failed = {});
+    Wire.injectNaks(0);
+    errors += failing.usedBytes() != used || failing.records() != records ||
+              failing.oldest() != head || failing.firstRecord() != 0;
+    MB85_FRAM_RingLog found(FRAM, LOG_START, LOG_SIZE);  // Memory has to agree with the RAM
+    errors += !found.begin() || found.records() != records || found.usedBytes() != used ||
+              found.oldest() != head || checkLog(found, reads) != 0;
+    Wire.stats = failed;
+    printStructure(names[i], 1, errors);
+    errors = 0;
+  }  // of for-next each failure
+  FRAM.setRetries(MB85_RETRIES);
+  Wire.resetStats();
+  errors = failing.pop() != logRecord(0, record) || failing.firstRecord() != 1 ||
+           !failing.append(record, logRecord(number, record));
+  addStats(failed = {});
+  errors += checkLog(failing, reads) != 0;
+  Wire.stats = failed;
+  printStructure("pop() and append() after", 2, errors);
+}  // of function "runRingLog()"
+/*! @brief  Record of the plain table searched by a linear scan, as done without the store */
+struct TableRecord {
+  uint32_t key;              ///< Record key
+  uint8_t  value[KV_VALUE];  ///< Record value
+};
+uint32_t kvKey(const uint16_t number) {
+  /*!
+   * @brief     Return the key of a record, numbers from KV_RECORDS on give keys not in the store
+   * @param[in] number Record number
+   * @return    Record key
+   */
+  return 1000 + number * 7919UL;
+}  // of function "kvKey()"
+uint32_t kvBucket(const uint16_t index) {
+  /*!
+   * @brief     Return the memory address of a bucket of the key value store
+   * @param[in] index Bucket index
+   * @return    Memory address
+   */
+  return KV_START + sizeof(MB85_KVHeader) + index * (sizeof(MB85_KVRecord) + KV_VALUE);
+}  // of function "kvBucket()"
+uint16_t kvCopies(MB85_FRAM_Class &FRAM, const uint32_t key) {
+  /*!
+   * @brief     Count the buckets holding a key by reading all of them
+   * @param[in] FRAM Memory holding the key value store
+   * @param[in] key Record key
+   * @return    Number of buckets holding the key
+   */
+  uint16_t copies = 0;
+  for (uint16_t i = 0; i < KV_BUCKETS; i++) {
+    MB85_KVRecord record;
+    FRAM.read(kvBucket(i), record);
+    copies += record.state == MB85_KV_USED && record.key == key;
+  }  // of for-next each bucket
+  return copies;
+}  // of function "kvCopies()"
+void kvValue(const uint32_t key, const uint8_t version, uint8_t value[]) {
+  /*!
+   * @brief      Build a repeatable value from a record key and version
+   * @param[in]  key Record key
+   * @param[in]  version Incremented on every update
+   * @param[out] value KV_VALUE bytes
+   */
+  for (uint8_t i = 0; i < KV_VALUE; i++) value[i] = (uint8_t)(key * 13 + i * 7 + version);
+}  // of function "kvValue()"
+uint32_t kvLookups(MB85_FRAM_KVStore &store, const bool hits, const uint8_t version) {
+  /*!
+   * @brief     Look up present or missing keys and check the values found
+   * @param[in] store Key value store
+   * @param[in] hits Look up keys in the store, otherwise keys which aren't
+   * @param[in] version Expected version of the values
+   * @return    Number of wrong results
+   */
+  uint8_t  value[KV_VALUE], expected[KV_VALUE];
+  uint32_t errors = 0;
+  for (uint16_t i = 0; i < KV_CALLS; i++) {
+    uint32_t key = kvKey(hits ? nextRandom() * 251U % KV_RECORDS : KV_RECORDS + i);
+    kvValue(key, version, expected);
+    uint8_t length = store.get(key, value, sizeof(value));
+    errors += hits ? length != KV_VALUE || memcmp(value, expected, KV_VALUE) != 0 : length != 0;
+  }  // of for-next each lookup
+  return errors;
+}  // of function "kvLookups()"
+void runKVStore() {
+  /*!
+   * @brief     Compare the key value store with and without fingerprints against a linear scan
+   * @details   The linear scan reads the key of each record in a plain table until it finds the
+   *            one looked up, which is how the records were found before the store existed
+   */
+  const Layout      layout = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  uint8_t           value[KV_VALUE], fingerprints[KV_BUCKETS];
+  uint32_t          errors = 0;
+  MB85_FRAM_Class   FRAM;
+  MB85_FRAM_KVStore store(FRAM, KV_START, KV_BUCKETS, KV_VALUE);
+  attachLayout(Wire, layout);
+  FRAM.begin(I2C_FAST_MODE);
+  for (uint16_t i = 0; i < KV_RECORDS; i++) {  // Plain table for the linear scan
+    TableRecord record;
+    record.key = kvKey(i);
+    kvValue(record.key, 0, record.value);
+    FRAM.write(KV_TABLE + i * sizeof(record), record);
+  }  // of for-next each table record
+  Wire.resetStats();
+  printf("%-28s %6s %8s %8s %9s %5s\n", "Operation", "Calls", "Trans/op", "Data/op", "Bus us/op",
+         "Err");
+  for (uint16_t i = 0; i < KV_CALLS; i++) {
+    uint32_t key = kvKey(nextRandom() * 251U % KV_RECORDS), found = 0;
+    uint16_t j   = 0;
+    for (; j < KV_RECORDS; j++) {
+      FRAM.read(KV_TABLE + j * sizeof(TableRecord), found);
+      if (found == key) break;
+    }  // of for-next each table record
+    uint8_t expected[KV_VALUE];
+    FRAM.read(KV_TABLE + j * sizeof(TableRecord) + sizeof(found), value);
+    kvValue(key, 0, expected);
+    errors += j == KV_RECORDS || memcmp(value, expected, KV_VALUE) != 0;
+  }  // of for-next each lookup
+  printStructure("Linear scan with read()", KV_CALLS, errors);
+  printStructure("begin() format", 1, !store.begin(true) || store.records() != 0);
+  errors = 0;
+  for (uint16_t i = 0; i < KV_RECORDS; i++) {
+    kvValue(kvKey(i), 0, value);
+    errors += !store.put(kvKey(i), value);
+  }  // of for-next each record
+  printStructure("put() new record", KV_RECORDS, errors + (store.records() != KV_RECORDS));
+  printStructure("get() hit", KV_CALLS, kvLookups(store, true, 0));
+  printStructure("get() miss", KV_CALLS, kvLookups(store, false, 0));
+  errors = 0;
+  for (uint16_t i = 0; i < KV_RECORDS; i++) {
+    kvValue(kvKey(i), 1, value);
+    errors += !store.put(kvKey(i), value);
+  }  // of for-next each record
+  printStructure("put() update in place", KV_RECORDS, errors + (store.records() != KV_RECORDS));
+  MB85_FRAM_KVStore fast(FRAM, KV_START, KV_BUCKETS, KV_VALUE, fingerprints);
+  printStructure("begin() with fingerprints", 1, !fast.begin() || fast.records() != KV_RECORDS);
+  printStructure("get() hit, fingerprints", KV_CALLS, kvLookups(fast, true, 1));
+  printStructure("get() miss, fingerprints", KV_CALLS, kvLookups(fast, false, 1));
+  errors = 0;
+  for (uint16_t i = 0; i < KV_RECORDS; i += 4) {
+    kvValue(kvKey(i), 1, value);
+    errors += !fast.remove(kvKey(i)) || fast.get(kvKey(i), value) || !fast.put(kvKey(i), value);
+  }  // of for-next each fourth record
+  printStructure("remove() and re-put()", KV_RECORDS / 4, errors);
+  printStructure("get() hit after remove()", KV_CALLS, kvLookups(fast, true, 1));
+  uint8_t home = 0;  // Damage a value byte directly in the memory
+  for (uint16_t i = 0; i < KV_BUCKETS && home == 0; i++) {
+    MB85_KVRecord record;
+    FRAM.read(kvBucket(i), record);
+    if (record.state == MB85_KV_USED && record.key == kvKey(1)) {
+      FRAM.write(kvBucket(i) + sizeof(record), (uint8_t)0x55);
+      home = 1;
+    }  // of if-then bucket found
+  }    // of for-next each bucket
+  Wire.resetStats();
+  errors = !home || fast.get(kvKey(1), value);
+  kvValue(kvKey(1), 1, value);
+  errors += !fast.put(kvKey(1), value) || !fast.get(kvKey(1), value);
+  printStructure("Damaged record and re-put()", 3, errors);
+  errors = 0;  // Update keys behind a deleted bucket while their bucket read fails
+  MB85_KVRecord previous = {0, MB85_KV_EMPTY, 0, 0};
+  uint16_t      updates  = 0;
+  I2CStats      failed   = {};  // Bus use of the failing updates only
+  for (uint16_t i = 0; i < KV_BUCKETS && updates < KV_FAILURES; i++) {
+    MB85_KVRecord record;
+    FRAM.read(kvBucket(i), record);
+    if (record.state == MB85_KV_USED && previous.state == MB85_KV_USED) {
+      uint16_t records = fast.records();
+      errors += !fast.remove(previous.key);  // Free bucket in front of the key
+      kvValue(record.key, 2, value);
+      FRAM.setRetries(0);
+      Wire.injectNaks(2);  // The bucket read fails, a write afterwards would succeed
+      Wire.resetStats();
+      errors += fast.put(record.key, value);
+      addStats(failed);
+      Wire.injectNaks(0);
+      FRAM.setRetries(MB85_RETRIES);
+      kvValue(previous.key, 1, value);
+      errors += !fast.put(previous.key, value) || fast.records() != records;
+      errors += kvCopies(FRAM, record.key) != 1 || kvCopies(FRAM, previous.key) != 1;
+      updates++;
+    }  // of if-then two records in a row
+    previous = record;
+  }  // of for-next each bucket
+  Wire.stats = failed;
+  printStructure("put() with failing read", updates, errors);
+  uint16_t records = fast.records();  // The store has to survive a begin() which can't read it
+  FRAM.setRetries(0);
+  Wire.injectNaks(1);
+  Wire.resetStats();
+  errors = fast.begin();
+  addStats(failed = {});
+  Wire.injectNaks(0);
+  FRAM.setRetries(MB85_RETRIES);
+  errors += !fast.begin() || fast.records() != records || records == 0;
+  Wire.stats = failed;
+  printStructure("begin() with failing read", 1, errors);
+}  // of function "runKVStore()"
+template <typename FRAM_TYPE>
+uint32_t statsRun(FRAM_TYPE &FRAM, const char *name, const uint32_t period, const uint8_t retries,
+                  const uint8_t seed) {
+  /*!
+   * @brief     Write and read back a block with every n-th I2C transaction failing
+   * @details   The library counters are added up over all memories and compared with those of the
+   *            simulated bus, the bus time of both is converted from their clock cycles in the
+   *            same way. busMicros() rounds down for each memory, so its sum may be up to one
+   *            microsecond per memory less. With retries every byte has to arrive, without them
+   *            the transfers have to end early and return the bytes done with a failure status.
+   * @tparam    FRAM_TYPE MB85_FRAM_Class or an MB85_FRAM_Fixed layout
+   * @param[in] FRAM Memories to use
+   * @param[in] name Name of the case
+   * @param[in] period Every n-th transaction fails, 0 for none
+   * @param[in] retries Repeats of a failed transaction
+   * @param[in] seed Start value of the block contents
+   * @return    Number of errors
+   */
+  static MB85_Stats stats[MB85_MAX_CHIPS];
+  uint8_t           block[STATS_BYTES], readBack[STATS_BYTES];
+  for (uint16_t i = 0; i < STATS_BYTES; i++) block[i] = (uint8_t)(seed + i * 7);
+  FRAM.setRetries(retries);
+  FRAM.attachStats(stats);
+  Wire.resetStats();
+  Wire.injectNaks(period);
+  uint32_t written = FRAM.writeBlock(STATS_START, block, STATS_BYTES);
+  uint8_t  status  = FRAM.status();
+  uint32_t read    = FRAM.readBlock(STATS_START, readBack, STATS_BYTES);
+  Wire.injectNaks(0);
+  MB85_Stats sum = {0, 0, 0, 0, 0};
+  uint32_t   busMicros = 0;
+  uint8_t    memories  = 0;
+  for (uint8_t i = 0; i < MB85_MAX_CHIPS; i++) {
+    if (FRAM.memSize(i) == 0) break;
+    memories++;
+    sum.transactions += stats[i].transactions;
+    sum.bytes += stats[i].bytes;
+    sum.naks += stats[i].naks;
+    sum.retries += stats[i].retries;
+    sum.clocks += stats[i].clocks;
+    busMicros += FRAM.busMicros(i);
+  }  // of for-next each memory
+  double   libMicros = (double)sum.clocks * 1000000.0 / I2C_FAST_MODE;  // As for the simulator
+  uint32_t errors = sum.transactions != Wire.stats.transactions || sum.naks != Wire.stats.naks ||
+                    sum.clocks != Wire.stats.clocks || sum.bytes != written + read;
+  errors += busMicros > libMicros || libMicros - busMicros >= memories;
+  if (retries) {
+    errors += written != STATS_BYTES || read != STATS_BYTES ||
+              memcmp(block, readBack, STATS_BYTES) != 0;
+  } else if (period) {
+    errors += written == STATS_BYTES || status == 0;  // Has to stop at the first failure
+  }  // of if-then-else retries
+  printf("%-31s %7u %7u %5u %7u %9.0f %9.0f %7u %7u %5u\n", name, sum.transactions, sum.bytes,
+         sum.naks, sum.retries, libMicros, Wire.busMicros(I2C_FAST_MODE), written, read, errors);
+  FRAM.attachStats(nullptr);
+  FRAM.setRetries(MB85_RETRIES);
+  totalErrors += errors;
+  return errors;
+}  // of function "statsRun()"
+void runStats() {
+  /*!
+   * @brief     Check the per-memory counters, the retries and the reported byte counts of both
+   *            MB85_FRAM_Class and MB85_FRAM_Fixed
+   */
+  const Layout    layout = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  MB85_FRAM_Class FRAM;
+  attachLayout(Wire, layout);
+  FRAM.begin(I2C_FAST_MODE);
+  printf("%-31s %7s %7s %5s %7s %9s %9s %7s %7s %5s\n", "Case", "Trans", "Bytes", "NAKs",
+         "Retries", "Lib us", "Sim us", "Written", "Read", "Err");
+  statsRun(FRAM, "No failures", 0, MB85_RETRIES, 1);
+  statsRun(FRAM, "1 in 50 fail, 2 retries", 50, MB85_RETRIES, 2);
+  statsRun(FRAM, "1 in 4 fail, 2 retries", 4, MB85_RETRIES, 3);
+  statsRun(FRAM, "1 in 50 fail, no retries", 50, 0, 4);
+  MB85_FRAM_Fixed<MB85RC256V, MB85RC256V, MB85RC256V, MB85RC256V> fixed;
+  fixed.begin(I2C_FAST_MODE);
+  statsRun(fixed, "Fixed, no failures", 0, MB85_RETRIES, 5);
+  statsRun(fixed, "Fixed, 1 in 4 fail, 2 retries", 4, MB85_RETRIES, 6);
+  statsRun(fixed, "Fixed, 1 in 50 fail, no retries", 50, 0, 7);
+}  // of function "runStats()"
+/*! @brief  Stream standing in for a serial port, returns the bytes in a buffer and appends the
+            bytes written to them */
+class ImageStream : public Stream {
+ public:
+  ImageStream(uint8_t *image, const uint32_t bytes) : _Image(image), _Read(0), _Written(bytes) {}
+  using Print::write;
+  size_t write(uint8_t value) {
+    _Image[_Written++] = value;
+    return 1;
+  }  // of method write()
+  int available() { return _Written - _Read; }
+  int read() { return _Read < _Written ? _Image[_Read++] : -1; }
+  int peek() { return _Read < _Written ? _Image[_Read] : -1; }
+
+ private:
+  uint8_t *_Image;    ///< Bytes written
+  uint32_t _Read;     ///< Bytes read back
+  uint32_t _Written;  ///< Bytes written
+};                    // of class ImageStream
+void printStream(const char *operation, const uint32_t calls, const uint32_t bytes,
+                 const uint32_t errors) {
+  /*!
+   * @brief     Print one result line for sequential access and clear the bus counters
+   * @param[in] operation Name of the operation
+   * @param[in] calls Number of library calls made
+   * @param[in] bytes Number of payload bytes moved by the calls
+   * @param[in] errors Number of wrong values
+   */
+  double micros = Wire.busMicros(I2C_FAST_MODE);
+  printf("%-32s %6u %8.3f %8.3f %9.1f %8.0f %5u\n", operation, calls,
+         (double)Wire.stats.transactions / calls, (double)Wire.stats.addressBytes / calls,
+         micros / calls, bytes * 1000000.0 / micros, errors + Wire.stats.dropped);
+  totalErrors += errors + Wire.stats.dropped;
+  Wire.resetStats();
+}  // of function "printStream()"
+void runStreams() {
+  /*!
+   * @brief     Compare element loops of read() and write() with MB85_FRAM_Array, and dump and
+   *            restore a memory image through MB85_FRAM_Stream
+   */
+  const Layout    layout = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  static uint8_t  image[IMAGE_BYTES], dump[IMAGE_BYTES];
+  uint32_t        errors = 0;
+  MB85_FRAM_Class FRAM;
+  attachLayout(Wire, layout);
+  FRAM.begin(I2C_FAST_MODE);
+  Wire.resetStats();
+  printf("%-32s %6s %8s %8s %9s %8s %5s\n", "Operation", "Calls", "Trans/op", "Addr/op",
+         "Bus us/op", "Bytes/s", "Err");
+  for (uint16_t i = 0; i < ARRAY_COUNT; i++) FRAM.write(ARRAY_START + 2 * i, (uint16_t)(i * 3));
+  printStream("write() loop, uint16_t", ARRAY_COUNT, 2 * ARRAY_COUNT, 0);
+  for (uint16_t i = 0; i < ARRAY_COUNT; i++) {
+    uint16_t value;
+    FRAM.read(ARRAY_START + 2 * i, value);
+    errors += value != (uint16_t)(i * 3);
+  }  // of for-next each element
+  printStream("read() loop, uint16_t", ARRAY_COUNT, 2 * ARRAY_COUNT, errors);
+  {
+    MB85_FRAM_Array<uint16_t> array(FRAM, ARRAY_START, ARRAY_COUNT);
+    for (uint16_t i = 0; i < ARRAY_COUNT; i++) array.set(i, (uint16_t)(i * 5));
+    array.flush();
+    printStream("MB85_FRAM_Array set()", ARRAY_COUNT, 2 * ARRAY_COUNT, 0);
+    errors = 0;
+    for (uint16_t i = 0; i < ARRAY_COUNT; i++) errors += array.get(i) != (uint16_t)(i * 5);
+    printStream("MB85_FRAM_Array get()", ARRAY_COUNT, 2 * ARRAY_COUNT, errors);
+    for (uint16_t i = 0; i < ARRAY_COUNT; i++) array[i] = array[i] + 1;
+    array.flush();
+    printStream("MB85_FRAM_Array a[i] = a[i] + 1", ARRAY_COUNT, 4 * ARRAY_COUNT, 0);
+  }  // Array goes out of scope
+  errors = 0;
+  for (uint16_t i = 0; i < ARRAY_COUNT; i++) {
+    uint16_t value;
+    FRAM.read(ARRAY_START + 2 * i, value);
+    errors += value != (uint16_t)(i * 5 + 1);
+  }  // of for-next each element
+  Wire.resetStats();
+  totalErrors += errors;
+  for (uint32_t i = 0; i < IMAGE_BYTES; i++) image[i] = (uint8_t)(i * 2654435761UL >> 24);
+  ImageStream      serial(image, IMAGE_BYTES);  // Bytes arriving over the serial port
+  MB85_FRAM_Stream stream(FRAM, IMAGE_START, IMAGE_BYTES);
+  for (int value; (value = serial.read()) >= 0;) stream.write((uint8_t)value);
+  stream.flush();
+  printStream("Stream restore, write() per byte", IMAGE_BYTES, IMAGE_BYTES, errors);
+  stream.seek(0);
+  ImageStream dumped(dump, 0);  // Bytes sent over the serial port
+  while (stream.available()) dumped.write((uint8_t)stream.read());
+  printStream("Stream dump, read() per byte", IMAGE_BYTES, IMAGE_BYTES,
+              memcmp(image, dump, IMAGE_BYTES) != 0);
+  stream.seek(0);
+  memset(dump, 0, IMAGE_BYTES);
+  uint32_t calls = 0;
+  for (uint32_t done = 0; done < IMAGE_BYTES; calls++) done += stream.read(dump + done, 64);
+  printStream("Stream dump, read() 64 bytes", calls, IMAGE_BYTES,
+              memcmp(image, dump, IMAGE_BYTES) != 0);
+}  // of function "runStreams()"
+void controlCycles(MB85_FRAM_Class &FRAM, const Field fields[], const bool batched,
+                   const char *name) {
+  /*!
+   * @brief     Run the control cycles with separate calls or through MB85_FRAM_Batch
+   * @details   The fields read hold a pattern written beforehand, the fields written get the cycle
+   *            number. The fields read are checked after every cycle and the fields written
+   *            after the last one
+   * @param[in] FRAM Memories to use
+   * @param[in] fields Fields of each cycle
+   * @param[in] batched Queue the fields once and call execute() in each cycle
+   * @param[in] name Name of the case
+   */
+  uint8_t         values[BATCH_FIELDS][4], expected[4];
+  uint32_t        errors = 0, cycle = 0;
+  MB85_FRAM_Batch batch(FRAM);
+  for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+    const Field &field = fields[i];
+    for (uint8_t j = 0; j < 4; j++) expected[j] = (uint8_t)(field.address + j);
+    if (!field.write) FRAM.writeBlock(field.address, expected, field.length);
+    if (batched && field.write) batch.queueWrite(field.address, values[i], field.length);
+    if (batched && !field.write) batch.queueRead(field.address, values[i], field.length);
+  }  // of for-next each field
+  Wire.resetStats();
+  for (; cycle < BATCH_CYCLES; cycle++) {
+    for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+      if (fields[i].write) memcpy(values[i], &cycle, 4);
+      if (!fields[i].write) memset(values[i], 0, 4);
+    }  // of for-next each field
+    if (batched) {
+      errors += batch.execute() != BATCH_FIELDS;
+    } else {
+      for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+        if (fields[i].write) FRAM.writeBlock(fields[i].address, values[i], fields[i].length);
+        if (!fields[i].write) FRAM.readBlock(fields[i].address, values[i], fields[i].length);
+      }  // of for-next each field
+    }    // of if-then-else batched
+    for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+      for (uint8_t j = 0; j < 4; j++) expected[j] = (uint8_t)(fields[i].address + j);
+      if (!fields[i].write) errors += memcmp(values[i], expected, fields[i].length) != 0;
+    }  // of for-next each field
+  }    // of for-next each cycle
+  printStructure(name, BATCH_CYCLES, errors);
+  cycle = BATCH_CYCLES - 1;
+  for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+    FRAM.readBlock(fields[i].address, expected, fields[i].length);
+    if (fields[i].write) totalErrors += memcmp(expected, &cycle, fields[i].length) != 0;
+  }  // of for-next each field
+  Wire.resetStats();
+}  // of function "controlCycles()"
+void runBatch() {
+  /*!
+   * @brief     Compare control cycles of a dozen fields made with separate calls and with
+   *            MB85_FRAM_Batch, on close fields which are merged and on scattered fields which
+   *            aren't, then check the merging of overlapping writes and reads
+   */
+  const Layout    layout = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  Field           scattered[BATCH_FIELDS];
+  uint32_t        errors = 0;
+  MB85_FRAM_Class FRAM;
+  attachLayout(Wire, layout);
+  FRAM.begin(I2C_FAST_MODE);
+  for (uint8_t i = 0; i < BATCH_FIELDS; i++) {
+    scattered[i]         = CONTROL_FIELDS[i];
+    scattered[i].address = 3000 + i * 10000;  // Far apart, across all memories
+  }  // of for-next each field
+  printf("%-28s %6s %8s %8s %9s %5s\n", "Operation", "Cycles", "Trans/op", "Data/op", "Bus us/op",
+         "Err");
+  controlCycles(FRAM, CONTROL_FIELDS, false, "Close fields, separate calls");
+  controlCycles(FRAM, CONTROL_FIELDS, true, "Close fields, execute()");
+  controlCycles(FRAM, scattered, false, "Scattered, separate calls");
+  controlCycles(FRAM, scattered, true, "Scattered, execute()");
+  uint8_t         zero[8] = {0}, ones[8], bytes[8], before[8], after[8];
+  uint16_t        word = 0;
+  uint8_t         byte = 0x55;
+  MB85_FRAM_Batch batch(FRAM);
+  memset(ones, 0xFF, sizeof(ones));
+  FRAM.writeBlock(4000, zero, sizeof(zero));
+  batch.queueWrite(4000, ones, 8);   // Partly overwritten by the later writes
+  batch.queueWrite(4002, word);      // Overlaps the first write
+  batch.queueRead(4000, before, 8);  // Done before the writes
+  batch.queueWrite(4006, byte);
+  Wire.resetStats();
+  errors += batch.execute() != 4;
+  I2CStats executed = Wire.stats;  // Without the read back
+  FRAM.readBlock(4000, after, sizeof(after));
+  memcpy(bytes, ones, sizeof(bytes));
+  bytes[2] = bytes[3] = 0;
+  bytes[6]            = byte;
+  errors += memcmp(before, zero, 8) != 0 || memcmp(after, bytes, 8) != 0;
+  Wire.stats = executed;
+  printStructure("Overlapping reads and writes", 1, errors);
+}  // of function "runBatch()"
+int main() {
+  /*!
+   * @brief   Run the benchmark for every layout
+   * @return  0 if all data was read back correctly, otherwise 1
+   */
+  printf("MB85_FRAM I2C benchmark, payload throughput in bytes per second of bus time\n");
+  for (uint8_t i = 0; i < sizeof(LAYOUTS) / sizeof(LAYOUTS[0]); i++) runLayout(LAYOUTS[i]);
+  printf("\nTwo I2C buses at 400kHz, bus time in microseconds, bytes per second of wall time\n");
+  for (uint8_t i = 0; i < sizeof(BUS_LAYOUTS) / sizeof(BUS_LAYOUTS[0]); i++) {
+    runBuses(BUS_LAYOUTS[i]);
+  }  // of for-next each bus layout
+  Wire1.detachAll();
+  printf("\nMemory detection by begin(), bus time in microseconds at 400kHz\n\n");
+  printf("%-40s %-8s %5s %7s %9s %8s %5s\n", "Layout", "Contents", "Chips", "Bytes", "begin us",
+         "Addr/op", "Err");
+  for (uint8_t i = 0; i < sizeof(DETECT_LAYOUTS) / sizeof(DETECT_LAYOUTS[0]); i++) {
+    runDetection(DETECT_LAYOUTS[i], RANDOM);
+    runDetection(DETECT_LAYOUTS[i], ZEROED);
+    runDetection(DETECT_LAYOUTS[i], ADDRESS);
+  }  // of for-next each detection layout
+  printf("\nMB85_FRAM_Class compared with MB85_FRAM_Fixed, CPU time in nanoseconds per call\n");
+  runFixed<MB85_FRAM_Fixed<MB85RC256V, MB85RC256V, MB85RC128A, MB85RC64>>(LAYOUTS[0]);
+  runFixed<MB85_FRAM_Fixed<MB85RC256V, MB85RC256V, MB85RC256V, MB85RC256V, MB85RC256V, MB85RC256V,
+                           MB85RC256V, MB85RC256V>>(LAYOUTS[1]);
+  runFixed<MB85_FRAM_Fixed<MB85RC1MT, MB85RC1MT, MB85RC04V, MB85RC04V>>(LAYOUTS[3]);
+  printf("\nSPI memory detection by begin(), bus time in microseconds at 20MHz\n\n");
+  printf("%-46s %5s %7s %9s %5s\n", "Layout", "Chips", "Bytes", "begin us", "Err");
+  for (uint8_t i = 0; i < sizeof(SPI_LAYOUTS) / sizeof(SPI_LAYOUTS[0]); i++) {
+    runSpiDetection(SPI_LAYOUTS[i]);
+  }  // of for-next each SPI layout
+  printf("\nI2C at 1MHz compared with SPI, payload bytes per second of bus time\n\n");
+  runSpiCompare();
+  printf("\nfill(), copy() and compare() on MB85RC256V x 4 at 400kHz\n\n");
+  const Layout i2c = {"", {32768, 32768, 32768, 32768}, {0x510, 0x510, 0x510, 0x510}};
+  attachLayout(Wire, i2c);
+  MB85_FRAM_Class FRAM;
+  FRAM.begin(I2C_FAST_MODE);
+  runPrimitives(FRAM, false, I2C_FAST_MODE);
+  printf("\nfill(), copy() and compare() on MB85RS256B x 4 at 20MHz\n\n");
+  attachSpiLayout(SPI_LAYOUTS[0]);
+  MB85_FRAM_SPI_Class spiFRAM(SPI, SPI_CS_PINS, SIM_SPI_CHIPS);
+  spiFRAM.begin();
+  runPrimitives(spiFRAM, true, MB85_SPI_CLOCK);
+  printf("\nRing log of %u bytes across a memory boundary, bus time at 400kHz\n\n", LOG_SIZE);
+  runRingLog();
+  printf("\nKey value store of %u records in %u buckets, bus time at 400kHz\n\n", KV_RECORDS,
+         KV_BUCKETS);
+  runKVStore();
+  printf("\nPer-memory counters and retries on MB85RC256V x 4 at 400kHz, %u bytes\n\n",
+         STATS_BYTES);
+  runStats();
+  printf("\nSequential access through MB85_FRAM_Array and MB85_FRAM_Stream at 400kHz\n\n");
+  runStreams();
+  printf("\nControl cycles of %u fields on MB85RC256V x 4, bus time at 400kHz\n\n", BATCH_FIELDS);
+  runBatch();
+  printf("\n%s: %u mismatched bytes\n", totalErrors ? "FAILED" : "PASSED", totalErrors);
+  return totalErrors ? 1 : 0;
+}  // of function "main()"
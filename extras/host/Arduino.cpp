@@ -0,0 +1,54 @@
+/*! @file Arduino.cpp
+ @section Arduino_cpp_intro_section Description
+
+ Host-side implementation of the Arduino core timing functions declared in Arduino.h
+*/
+#include "Arduino.h"  // Include the header definition
+
+#include <chrono>  // Host clock
+#include <thread>  // sleep_for()
+
+static const std::chrono::steady_clock::time_point startTime =
+    std::chrono::steady_clock::now();  ///< Program start time
+void (*simPinHook)(uint8_t pin, uint8_t value) = nullptr;  ///< Digital output observer
+
+unsigned long micros() {
+  /*!
+   * @brief   Return the number of microseconds since the program started
+   * @return  Microseconds since start
+   */
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - startTime)
+      .count();
+}  // of function "micros()"
+unsigned long millis() {
+  /*!
+   * @brief   Return the number of milliseconds since the program started
+   * @return  Milliseconds since start
+   */
+  return micros() / 1000;
+}  // of function "millis()"
+void delay(unsigned long ms) {
+  /*!
+   * @brief     Wait for the given number of milliseconds
+   * @param[in] ms Milliseconds to wait
+   */
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}  // of function "delay()"
+void pinMode(uint8_t pin, uint8_t mode) {
+  /*!
+   * @brief     Set the mode of a pin, nothing needs to be done in the simulation
+   * @param[in] pin Pin number
+   * @param[in] mode INPUT or OUTPUT
+   */
+  (void)pin;
+  (void)mode;
+}  // of function "pinMode()"
+void digitalWrite(uint8_t pin, uint8_t value) {
+  /*!
+   * @brief     Set a digital output and pass the change on to the simulation hook
+   * @param[in] pin Pin number
+   * @param[in] value LOW or HIGH
+   */
+  if (simPinHook != nullptr) simPinHook(pin, value);
+}  // of function "digitalWrite()"
@@ -0,0 +1,34 @@
+/*! @file Arduino.h
+ @section Arduino_intro_section Description
+
+ Minimal host-side replacement for the Arduino core header. It only declares the handful of types
+ and functions used by the MB85_FRAM library so that the library can be compiled and benchmarked on
+ a Linux host together with the simulated "Wire" and "SPI" libraries in this directory. Changes of
+ the digital outputs are passed to an optional hook, which the simulated SPI library uses to follow
+ the chip select pins. See the header of extras/benchmark/Benchmark.cpp for the build command.
+*/
+#ifndef Arduino_h
+  /** @brief  Guard code to prevent multiple definitions */
+  #define Arduino_h
+  #include <stddef.h>  // size_t definition
+  #include <stdint.h>  // Fixed width integer types
+  #include <stdlib.h>  // Standard library functions
+  #include <string.h>  // memcpy() and friends
+
+typedef uint8_t byte;     ///< Arduino "byte" data type
+typedef bool    boolean;  ///< Arduino "boolean" data type
+
+const uint8_t LOW{0};       ///< Digital output low
+const uint8_t HIGH{1};      ///< Digital output high
+const uint8_t INPUT{0};     ///< Pin mode input
+const uint8_t OUTPUT{1};    ///< Pin mode output
+const uint8_t LSBFIRST{0};  ///< Bit order least significant bit first
+const uint8_t MSBFIRST{1};  ///< Bit order most significant bit first
+
+unsigned long micros();                                  ///< Microseconds since program start
+unsigned long millis();                                  ///< Milliseconds since program start
+void          delay(unsigned long ms);                   ///< Wait for a number of milliseconds
+void          pinMode(uint8_t pin, uint8_t mode);        ///< Set the mode of a pin
+void          digitalWrite(uint8_t pin, uint8_t value);  ///< Set a digital output
+extern void (*simPinHook)(uint8_t pin, uint8_t value);   ///< Called on every digitalWrite()
+#endif
@@ -0,0 +1,222 @@
+/*! @file SPI.cpp
+ @section SPI_cpp_intro_section Description
+
+ Host-side implementation of the simulated "SPI" library, see SPI.h for details
+*/
+#include "SPI.h"  // Include the header definition
+
+const uint8_t SIM_WREN{0x06};       ///< Set the write enable latch
+const uint8_t SIM_WRDI{0x04};       ///< Reset the write enable latch
+const uint8_t SIM_READ{0x03};       ///< Read memory
+const uint8_t SIM_FAST_READ{0x0B};  ///< Read memory after a dummy byte
+const uint8_t SIM_WRITE{0x02};      ///< Write memory
+const uint8_t SIM_RDID{0x9F};       ///< Read the device ID
+
+SPIClass SPI;  ///< Default bus instance
+
+static void spiPinHook(uint8_t pin, uint8_t value) {
+  /*!
+   * @brief     Pass a change of a digital output on to the simulated bus
+   * @param[in] pin Pin number
+   * @param[in] value LOW or HIGH
+   */
+  SPI.pinChanged(pin, value);
+}  // of function "spiPinHook()"
+
+SPIClass::SPIClass()
+    : _Selected(nullptr), _InTransaction(false), _Command(0), _Position(0), _Address(0) {
+  /*!
+   * @brief   Class constructor
+   * @details Starts with no memories attached and all counters cleared
+   */
+  detachAll();
+  resetStats();
+  simPinHook = spiPinHook;
+}  // of class constructor
+void SPIClass::begin() {
+  /*!
+   * @brief   Start the bus, nothing needs to be done in the simulation
+   */
+}  // of method "begin()"
+void SPIClass::end() {
+  /*!
+   * @brief   Stop the bus, nothing needs to be done in the simulation
+   */
+}  // of method "end()"
+void SPIClass::beginTransaction(const SPISettings settings) {
+  /*!
+   * @brief     Take the bus with the given clock, bit order and mode
+   * @param[in] settings Transaction settings
+   */
+  _Settings      = settings;
+  _InTransaction = true;
+}  // of method "beginTransaction()"
+void SPIClass::endTransaction() {
+  /*!
+   * @brief   Release the bus
+   */
+  _InTransaction = false;
+}  // of method "endTransaction()"
+uint8_t SPIClass::transfer(const uint8_t data) {
+  /*!
+   * @brief     Send one byte and return the byte received at the same time
+   * @details   The selected memory decodes the opcode from the first byte of the chip select
+   *            window, followed by the memory address for READ, FAST_READ and WRITE. Nobody drives
+   *            MISO while no memory is selected, so 0xFF is returned then.
+   * @param[in] data Byte to send
+   * @return    Byte received
+   */
+  stats.clocks += 8;
+  if (_Selected == nullptr || !_InTransaction || _Settings.bitOrder != MSBFIRST) {
+    stats.ignored++;
+    return 0xFF;
+  }  // of if-then nobody listens
+  SimSpiChip *chip     = _Selected;
+  uint32_t    position = _Position++;  // Byte position in the chip select window
+  if (position == 0) {
+    _Command = data;
+    _Address = 0;
+    stats.commandBytes++;
+    if (_Command == SIM_WREN) chip->writeEnable = true;
+    if (_Command == SIM_WRDI) chip->writeEnable = false;
+    return 0xFF;
+  }  // of if-then opcode
+  switch (_Command) {
+    case SIM_RDID:
+      stats.commandBytes++;
+      if (chip->product == 0 || position > 4) return 0xFF;  // No ID
+      return position == 1   ? 0x04                         // Fujitsu
+             : position == 2 ? 0x7F                         // Continuation code
+             : position == 3 ? chip->product >> 8
+                             : chip->product & 0xFF;
+    case SIM_READ:
+    case SIM_FAST_READ:
+    case SIM_WRITE: {
+      uint32_t dummy = _Command == SIM_FAST_READ ? 1 : 0;
+      if (position <= chip->addressBytes + dummy) {  // Address and dummy bytes
+        stats.commandBytes++;
+        if (position <= chip->addressBytes) _Address = (_Address << 8) | data;
+        if (position == chip->addressBytes + dummy) _Address &= chip->bytes - 1;
+        return 0xFF;
+      }  // of if-then address phase
+      stats.payloadBytes++;
+      uint8_t value = 0xFF;
+      if (_Command == SIM_WRITE) {
+        if (chip->writeEnable) chip->memory[_Address] = data;  // Protected without WREN
+      } else {
+        value = chip->memory[_Address];
+      }                                             // of if-then-else write
+      _Address = (_Address + 1) & (chip->bytes - 1);  // Wrap around at the end of memory
+      return value;
+    }  // of case memory access
+    default:
+      stats.ignored++;
+      return 0xFF;
+  }  // of switch command
+}  // of method "transfer()"
+void SPIClass::transfer(void *buffer, const size_t count) {
+  /*!
+   * @brief         Send a buffer and replace its contents with the bytes received
+   * @param[in,out] buffer Bytes to send, overwritten with the bytes received
+   * @param[in]     count Number of bytes
+   */
+  uint8_t *bytes = (uint8_t *)buffer;
+  for (size_t i = 0; i < count; i++) bytes[i] = transfer(bytes[i]);
+}  // of method "transfer()"
+bool SPIClass::attachChip(const uint8_t csPin, const uint32_t bytes, const uint16_t product) {
+  /*!
+   * @brief     Attach a simulated memory to the bus
+   * @details   The memory is filled with a repeatable pseudo-random pattern, as the contents of a
+   *            real memory are unknown at startup
+   * @param[in] csPin Chip select pin, must not be 0
+   * @param[in] bytes Memory size in bytes, must be a power of 2
+   * @param[in] product 16 bit product ID returned after the manufacturer ID 0x04 and continuation
+   *            code 0x7F by the RDID command, 0 for memories which don't support the command
+   * @return    true if the memory was attached
+   */
+  if (csPin == 0 || findChip(csPin) != nullptr) return false;
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {
+    if (_Chips[i].csPin == 0) {
+      _Chips[i].csPin        = csPin;
+      _Chips[i].addressBytes = bytes > 65536 ? 3 : 2;
+      _Chips[i].bytes        = bytes;
+      _Chips[i].product      = product;
+      _Chips[i].writeEnable  = false;
+      _Chips[i].memory.resize(bytes);
+      uint32_t seed = 0x7F4A7C15 * csPin;
+      for (uint32_t j = 0; j < bytes; j++) {
+        seed                = seed * 1103515245 + 12345;
+        _Chips[i].memory[j] = (uint8_t)(seed >> 16);
+      }  // of for-next each byte
+      return true;
+    }  // of if-then free slot found
+  }    // of for-next each slot
+  return false;
+}  // of method "attachChip()"
+void SPIClass::detachAll() {
+  /*!
+   * @brief   Remove all simulated memories from the bus
+   */
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {
+    _Chips[i].csPin = 0;
+    _Chips[i].bytes = 0;
+    _Chips[i].memory.clear();
+  }  // of for-next each slot
+  _Selected = nullptr;
+}  // of method "detachAll()"
+uint8_t *SPIClass::chipMemory(const uint8_t csPin, uint32_t *bytes) {
+  /*!
+   * @brief      Return direct access to the contents of a simulated memory
+   * @param[in]  csPin Chip select pin
+   * @param[out] bytes Optional, set to the memory size in bytes
+   * @return     Pointer to the memory contents or nullptr if there is no memory on the pin
+   */
+  SimSpiChip *chip = findChip(csPin);
+  if (bytes != nullptr) *bytes = chip == nullptr ? 0 : chip->bytes;
+  return chip == nullptr ? nullptr : chip->memory.data();
+}  // of method "chipMemory()"
+void SPIClass::resetStats() {
+  /*!
+   * @brief   Clear all bus usage counters
+   */
+  memset(&stats, 0, sizeof(stats));
+}  // of method "resetStats()"
+double SPIClass::busMicros(const uint32_t clock) const {
+  /*!
+   * @brief     Return the estimated bus time for the accumulated counters at the given clock
+   * @param[in] clock SCK clock in Hz
+   * @return    Bus time in microseconds
+   */
+  return (double)stats.clocks * 1000000.0 / clock;
+}  // of method "busMicros()"
+void SPIClass::pinChanged(const uint8_t pin, const uint8_t value) {
+  /*!
+   * @brief     Follow the chip select pins
+   * @details   A falling edge selects a memory and starts a new command, a rising edge ends the
+   *            command. The write enable latch is reset at the end of a WRITE, as on the real
+   *            memories. Each chip select window is counted as one transaction.
+   * @param[in] pin Pin number
+   * @param[in] value LOW or HIGH
+   */
+  SimSpiChip *chip = findChip(pin);
+  if (chip == nullptr) return;
+  if (value == LOW && _Selected != chip) {
+    _Selected = chip;
+    _Position = 0;
+    stats.transactions++;
+  } else if (value == HIGH && _Selected == chip) {
+    if (_Position > 0 && _Command == SIM_WRITE) chip->writeEnable = false;
+    _Selected = nullptr;
+  }  // of if-then-else chip select edge
+}  // of method "pinChanged()"
+SimSpiChip *SPIClass::findChip(const uint8_t csPin) {
+  /*!
+   * @brief     Return the memory on a chip select pin
+   * @param[in] csPin Chip select pin
+   * @return    Pointer to the memory or nullptr if there is none
+   */
+  for (uint8_t i = 0; i < SIM_SPI_CHIPS; i++) {
+    if (_Chips[i].csPin != 0 && _Chips[i].csPin == csPin) return &_Chips[i];
+  }  // of for-next each slot
+  return nullptr;
+}  // of method "findChip()"
@@ -0,0 +1,94 @@
+/*! @file SPI.h
+ @section SPI_intro_section Description
+
+ Host-side replacement for the Arduino "SPI" library. The SPIClass class implements the subset of
+ the Arduino API used by the MB85_FRAM library and, instead of driving real hardware, simulates up
+ to 8 MB85RS memories, each selected by its own chip select pin. The chip select pins are followed
+ through the digitalWrite() hook of the simulated Arduino core. The memories decode the WREN, WRDI,
+ READ, FAST_READ, WRITE and RDID commands like the real parts: a WRITE is ignored unless it follows
+ a WREN in an earlier chip select window, memories of more than 64kB take 3 address bytes and the
+ address counter wraps around from the highest address back to 0.\n\n
+
+ Every chip select window is counted as a transaction, split into command bytes (opcode, memory
+ address and dummy bytes) and payload bytes, and the number of SCK clock cycles used is accumulated
+ so that the bus time at any SPI clock can be estimated.
+*/
+#ifndef SPI_h
+  /** @brief  Guard code to prevent multiple definitions */
+  #define SPI_h
+  #include <vector>  // Simulated memory contents
+
+  #include "Arduino.h"  // Arduino data type definitions
+const uint8_t SIM_SPI_CHIPS{8};  ///< Number of simulated memories on the SPI bus
+const uint8_t SPI_MODE0{0x00};   ///< Clock idle low, data sampled on the rising edge
+const uint8_t SPI_MODE3{0x0C};   ///< Clock idle high, data sampled on the rising edge
+
+/*! @brief  Bus usage counters accumulated by the simulated SPIClass class */
+struct SPIStats {
+  uint32_t transactions;  ///< Number of chip select windows
+  uint32_t commandBytes;  ///< Opcode, memory address and dummy bytes
+  uint32_t payloadBytes;  ///< Data bytes read or written
+  uint32_t ignored;       ///< Bytes sent while no memory was selected or to an unknown command
+  uint64_t clocks;        ///< SCK clock cycles used
+};
+
+/*! @brief  One simulated MB85RS memory chip */
+struct SimSpiChip {
+  uint8_t              csPin;         ///< Chip select pin, 0 if unused
+  uint8_t              addressBytes;  ///< Number of memory address bytes, 2 or 3
+  uint32_t             bytes;         ///< Memory size in bytes (power of 2)
+  uint16_t             product;       ///< 16 bit product ID returned by RDID, 0 if not supported
+  bool                 writeEnable;   ///< Write enable latch
+  std::vector<uint8_t> memory;        ///< Memory contents
+};
+
+class SPISettings {
+  /*!
+   * @class   SPISettings
+   * @brief   SPI clock, bit order and mode of a transaction
+   */
+ public:
+  SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;     ///< SCK clock in Hz
+  uint8_t  bitOrder;  ///< MSBFIRST or LSBFIRST
+  uint8_t  dataMode;  ///< SPI_MODE0 to SPI_MODE3
+};  // of class SPISettings
+
+class SPIClass {
+  /*!
+   * @class   SPIClass
+   * @brief   Simulated SPI bus with attached MB85RS memories
+   */
+ public:
+  SPIClass();
+  void    begin();
+  void    end();
+  void    beginTransaction(const SPISettings settings);
+  void    endTransaction();
+  uint8_t transfer(const uint8_t data);
+  void    transfer(void *buffer, const size_t count);
+  /*************************************************************************************************
+  ** Simulator methods, these are not part of the Arduino API                                     **
+  *************************************************************************************************/
+  bool     attachChip(const uint8_t csPin, const uint32_t bytes, const uint16_t product = 0);
+  void     detachAll();
+  uint8_t *chipMemory(const uint8_t csPin, uint32_t *bytes = nullptr);
+  void     resetStats();
+  double   busMicros(const uint32_t clock) const;
+  void     pinChanged(const uint8_t pin, const uint8_t value);
+  SPIStats stats;  ///< Accumulated bus usage counters
+
+ private:
+  SimSpiChip *findChip(const uint8_t csPin);
+  SimSpiChip  _Chips[SIM_SPI_CHIPS];  ///< Attached memories
+  SimSpiChip *_Selected;              ///< Memory with its chip select low, nullptr if none
+  SPISettings _Settings;              ///< Settings of the current transaction
+  bool        _InTransaction;         ///< Set between beginTransaction() and endTransaction()
+  uint8_t     _Command;               ///< Opcode of the current chip select window
+  uint32_t    _Position;              ///< Bytes received in the current chip select window
+  uint32_t    _Address;               ///< Memory address of the current command
+};  // of class SPIClass
+extern SPIClass SPI;  ///< Default bus instance, as in the Arduino library
+#endif
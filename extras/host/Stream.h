@@ -0,0 +1,66 @@
+/*! @file Stream.h
+ @section Stream_intro_section Description
+
+ Host-side replacement for the Print and Stream base classes of the Arduino core. Only the virtual
+ methods which the MB85_FRAM_Stream class overrides and the plain block and string writes are
+ declared, which is enough to use MB85_FRAM_Stream wherever a Stream is expected and to write
+ stream sinks such as a simulated serial port in the benchmark.
+*/
+#ifndef Stream_h
+  /** @brief  Guard code to prevent multiple definitions */
+  #define Stream_h
+  #include "Arduino.h"  // Arduino data type definitions
+
+class Print {
+  /*!
+   * @class   Print
+   * @brief   Base class of everything bytes can be written to
+   */
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    /*!
+     * @brief     Write a block of bytes one at a time, derived classes may do better
+     * @param[in] buffer Bytes to write
+     * @param[in] size Number of bytes
+     * @return    Number of bytes written
+     */
+    size_t written = 0;
+    while (size-- && write(*buffer++)) written++;
+    return written;
+  }  // of method write()
+  size_t write(const char *text) {
+    /*!
+     * @brief     Write a zero-terminated string without the terminator
+     * @param[in] text String to write
+     * @return    Number of bytes written
+     */
+    return text == nullptr ? 0 : write((const uint8_t *)text, strlen(text));
+  }  // of method write()
+  virtual int availableForWrite() { return 0; }  ///< Bytes which can be written without blocking
+  virtual void flush() {}                        ///< Wait until all written bytes have been sent
+};                                               // of class Print
+
+class Stream : public Print {
+  /*!
+   * @class   Stream
+   * @brief   Base class of everything bytes can be written to and read from
+   */
+ public:
+  virtual int available() = 0;  ///< Number of bytes which can be read
+  virtual int read()      = 0;  ///< Read the next byte, -1 if there is none
+  virtual int peek()      = 0;  ///< Return the next byte without reading it, -1 if there is none
+  size_t      readBytes(uint8_t *buffer, size_t length) {
+    /*!
+     * @brief      Read bytes until the length is reached or no more bytes are available
+     * @param[out] buffer Buffer to read to
+     * @param[in]  length Number of bytes wanted
+     * @return     Number of bytes read
+     */
+    size_t done = 0;
+    for (int value; done < length && (value = read()) >= 0; done++) buffer[done] = (uint8_t)value;
+    return done;
+  }  // of method readBytes()
+};   // of class Stream
+#endif
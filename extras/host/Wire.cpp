@@ -0,0 +1,311 @@
+/*! @file Wire.cpp
+ @section Wire_cpp_intro_section Description
+
+ Host-side implementation of the simulated "Wire" library, see Wire.h for details
+*/
+#include "Wire.h"  // Include the header definition
+
+TwoWire Wire;   ///< Default bus instance
+TwoWire Wire1;  ///< Second bus instance
+
+TwoWire::TwoWire()
+    : _Clock(100000),
+      _TxAddress(0),
+      _TxLength(0),
+      _RxLength(0),
+      _RxIndex(0),
+      _IdAddress(0),
+      _NakPeriod(0),
+      _NakCount(0) {
+  /*!
+   * @brief   Class constructor
+   * @details Starts with no memories attached and all counters cleared
+   */
+  detachAll();
+  resetStats();
+}  // of class constructor
+void TwoWire::begin() {
+  /*!
+   * @brief   Start the bus, nothing needs to be done in the simulation
+   */
+}  // of method "begin()"
+void TwoWire::setClock(const uint32_t clock) {
+  /*!
+   * @brief     Set the bus clock
+   * @param[in] clock Clock speed in Hz
+   */
+  _Clock = clock;
+}  // of method "setClock()"
+uint32_t TwoWire::getClock() const {
+  /*!
+   * @brief   Return the bus clock
+   * @return  Clock speed in Hz
+   */
+  return _Clock;
+}  // of method "getClock()"
+void TwoWire::injectNaks(const uint32_t period) {
+  /*!
+   * @brief     Let every n-th transaction to a memory fail as if the slave address wasn't
+   *            acknowledged, nothing is written and no data is returned
+   * @param[in] period Number of transactions from one failure to the next, 0 to stop failures
+   */
+  _NakPeriod = period;
+  _NakCount  = 0;
+}  // of method "injectNaks()"
+void TwoWire::beginTransmission(const uint8_t address) {
+  /*!
+   * @brief     Start filling the transmit buffer for the given slave address
+   * @param[in] address 7-bit I2C slave address
+   */
+  _TxAddress = address;
+  _TxLength  = 0;
+}  // of method "beginTransmission()"
+void TwoWire::beginTransmission(const int address) {
+  /*!
+   * @brief     Start filling the transmit buffer for the given slave address
+   * @param[in] address 7-bit I2C slave address
+   */
+  beginTransmission((uint8_t)address);
+}  // of method "beginTransmission()"
+size_t TwoWire::write(const uint8_t data) {
+  /*!
+   * @brief     Add a byte to the transmit buffer
+   * @param[in] data Byte to transmit
+   * @return    1 if the byte was stored, 0 if the buffer was full
+   */
+  if (_TxLength >= BUFFER_LENGTH) {
+    stats.dropped++;
+    return 0;
+  }  // of if-then buffer is full
+  _TxBuffer[_TxLength++] = data;
+  return 1;
+}  // of method "write()"
+size_t TwoWire::write(const uint8_t *data, const size_t quantity) {
+  /*!
+   * @brief     Add a number of bytes to the transmit buffer
+   * @param[in] data Bytes to transmit
+   * @param[in] quantity Number of bytes
+   * @return    Number of bytes stored
+   */
+  size_t stored = 0;
+  for (size_t i = 0; i < quantity; i++) stored += write(data[i]);
+  return stored;
+}  // of method "write()"
+uint8_t TwoWire::endTransmission(const uint8_t sendStop) {
+  /*!
+   * @brief     Send the transmit buffer to the addressed memory
+   * @details   The first 1 or 2 bytes sent to a memory, together with the lowest bits of the slave
+   *            address for memories answering on several slave addresses, set its internal address
+   *            counter and all further bytes are stored at the counter, which wraps around at the
+   *            end of the memory. An incomplete address leaves the counter unchanged.
+   * @param[in] sendStop Send a STOP condition when true, otherwise the next transaction begins
+   *            with a repeated START
+   * @return    0 on success, 2 if the slave address was not acknowledged
+   */
+  if (_TxAddress == SIM_DEVICE_ID_ADDRESS && hasDeviceId()) {  // Device ID command
+    if (_TxLength > 0) _IdAddress = _TxBuffer[0] >> 1;          // Select the memory
+    countTransaction(1 + _TxLength, 0, sendStop);
+    _TxLength = 0;
+    return 0;
+  }  // of if-then Device ID command
+  SimChip *chip = findChip(_TxAddress);
+  if (chip == nullptr || (_NakPeriod && ++_NakCount % _NakPeriod == 0)) {
+    stats.naks++;
+    countTransaction(1, 0, sendStop);
+    _TxLength = 0;
+    return 2;
+  }  // of if-then no memory at this address or injected failure
+  uint8_t addressLength = _TxLength < chip->addressBytes ? _TxLength : chip->addressBytes;
+  if (addressLength == chip->addressBytes) {
+    uint32_t address = _TxAddress - chip->address;  // Upper address bits from the slave address
+    for (uint8_t i = 0; i < addressLength; i++) address = (address << 8) | _TxBuffer[i];
+    chip->latch = address & (chip->bytes - 1);
+  }  // of if-then address has been sent
+  for (uint8_t i = addressLength; i < _TxLength; i++) {
+    chip->memory[chip->latch] = _TxBuffer[i];
+    chip->latch               = (chip->latch + 1) & (chip->bytes - 1);
+  }  // of for-next each data byte
+  countTransaction(1 + addressLength, _TxLength - addressLength, sendStop);
+  _TxLength = 0;
+  return 0;
+}  // of method "endTransmission()"
+uint8_t TwoWire::requestFrom(const uint8_t address, const uint8_t quantity) {
+  /*!
+   * @brief     Read bytes from the internal address counter of a memory into the receive buffer
+   * @param[in] address 7-bit I2C slave address
+   * @param[in] quantity Number of bytes to read, limited to BUFFER_LENGTH
+   * @return    Number of bytes read
+   */
+  _RxLength = 0;
+  _RxIndex  = 0;
+  if (address == SIM_DEVICE_ID_ADDRESS && hasDeviceId()) {  // Device ID command
+    SimChip *chip  = findChip(_IdAddress);                  // Memory selected for the ID
+    uint8_t  id[3] = {0xFF, 0xFF, 0xFF};                    // Nobody drives the bus by default
+    if (chip != nullptr && chip->product != 0) {
+      id[0] = 0x00;                         // Manufacturer ID 0x00A, bits 11-4
+      id[1] = 0xA0 | (chip->product >> 8);  // Manufacturer bits 3-0, density
+      id[2] = (uint8_t)chip->product;       // Rest of the product ID
+    }                                       // of if-then memory has a Device ID
+    uint8_t length = quantity > BUFFER_LENGTH ? BUFFER_LENGTH : quantity;
+    for (uint8_t i = 0; i < length; i++) _RxBuffer[i] = i < 3 ? id[i] : 0xFF;
+    _RxLength = length;
+    countTransaction(1, length, true);
+    return length;
+  }  // of if-then Device ID command
+  SimChip *chip = findChip(address);
+  if (chip == nullptr || (_NakPeriod && ++_NakCount % _NakPeriod == 0)) {
+    stats.naks++;
+    countTransaction(1, 0, true);
+    return 0;
+  }  // of if-then no memory at this address or injected failure
+  uint8_t length = quantity > BUFFER_LENGTH ? BUFFER_LENGTH : quantity;
+  for (uint8_t i = 0; i < length; i++) {
+    _RxBuffer[i] = chip->memory[chip->latch];
+    chip->latch  = (chip->latch + 1) & (chip->bytes - 1);
+  }  // of for-next each byte
+  _RxLength = length;
+  countTransaction(1, length, true);
+  return length;
+}  // of method "requestFrom()"
+uint8_t TwoWire::requestFrom(const int address, const int quantity) {
+  /*!
+   * @brief     Read bytes from the internal address counter of a memory into the receive buffer
+   * @param[in] address 7-bit I2C slave address
+   * @param[in] quantity Number of bytes to read, limited to BUFFER_LENGTH
+   * @return    Number of bytes read
+   */
+  return requestFrom((uint8_t)address,
+                     (uint8_t)(quantity > BUFFER_LENGTH ? BUFFER_LENGTH : quantity));
+}  // of method "requestFrom()"
+int TwoWire::available() {
+  /*!
+   * @brief   Return the number of unread bytes in the receive buffer
+   * @return  Bytes available
+   */
+  return _RxLength - _RxIndex;
+}  // of method "available()"
+int TwoWire::read() {
+  /*!
+   * @brief   Return the next byte from the receive buffer
+   * @return  Byte value or -1 if the buffer is empty
+   */
+  if (_RxIndex >= _RxLength) return -1;
+  return _RxBuffer[_RxIndex++];
+}  // of method "read()"
+int TwoWire::peek() {
+  /*!
+   * @brief   Return the next byte from the receive buffer without removing it
+   * @return  Byte value or -1 if the buffer is empty
+   */
+  if (_RxIndex >= _RxLength) return -1;
+  return _RxBuffer[_RxIndex];
+}  // of method "peek()"
+bool TwoWire::attachChip(const uint8_t address, const uint32_t bytes, const uint16_t product) {
+  /*!
+   * @brief     Attach a simulated memory to the bus
+   * @details   The memory is filled with a repeatable pseudo-random pattern, as the contents of a
+   *            real memory are unknown at startup. Memories of up to 2kB take 1 address byte and
+   *            memories which need more address bits answer on several slave addresses.
+   * @param[in] address First 7-bit I2C slave address
+   * @param[in] bytes Memory size in bytes, must be a power of 2
+   * @param[in] product 12 bit product ID returned by the Device ID command, 0 for memories which
+   *            don't support the command
+   * @return    true if the memory was attached
+   */
+  if (findChip(address) != nullptr) return false;
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    if (_Chips[i].address == 0) {
+      _Chips[i].address      = address;
+      _Chips[i].addressBytes = bytes <= 2048 ? 1 : 2;
+      _Chips[i].slaves       = 1;
+      while (((uint32_t)_Chips[i].slaves << (8 * _Chips[i].addressBytes)) < bytes) {
+        _Chips[i].slaves *= 2;  // Upper address bits are taken from the slave address
+      }                         // of while more address bits are needed
+      _Chips[i].bytes   = bytes;
+      _Chips[i].product = product;
+      _Chips[i].latch   = 0;
+      _Chips[i].memory.resize(bytes);
+      uint32_t seed = 0x9E3779B9 * address;
+      for (uint32_t j = 0; j < bytes; j++) {
+        seed                = seed * 1103515245 + 12345;
+        _Chips[i].memory[j] = (uint8_t)(seed >> 16);
+      }  // of for-next each byte
+      return true;
+    }  // of if-then free slot found
+  }    // of for-next each slot
+  return false;
+}  // of method "attachChip()"
+void TwoWire::detachAll() {
+  /*!
+   * @brief   Remove all simulated memories from the bus
+   */
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    _Chips[i].address = 0;
+    _Chips[i].bytes   = 0;
+    _Chips[i].memory.clear();
+  }  // of for-next each slot
+}  // of method "detachAll()"
+uint8_t *TwoWire::chipMemory(const uint8_t address, uint32_t *bytes) {
+  /*!
+   * @brief      Return direct access to the contents of a simulated memory
+   * @param[in]  address 7-bit I2C slave address
+   * @param[out] bytes Optional, set to the memory size in bytes
+   * @return     Pointer to the memory contents or nullptr if there is no memory at the address
+   */
+  SimChip *chip = findChip(address);
+  if (bytes != nullptr) *bytes = chip == nullptr ? 0 : chip->bytes;
+  return chip == nullptr ? nullptr : chip->memory.data();
+}  // of method "chipMemory()"
+void TwoWire::resetStats() {
+  /*!
+   * @brief   Clear all bus usage counters
+   */
+  memset(&stats, 0, sizeof(stats));
+}  // of method "resetStats()"
+double TwoWire::busMicros(const uint32_t clock) const {
+  /*!
+   * @brief     Return the estimated bus time for the accumulated counters at the given clock
+   * @param[in] clock Clock speed in Hz
+   * @return    Bus time in microseconds
+   */
+  return (double)stats.clocks * 1000000.0 / clock;
+}  // of method "busMicros()"
+bool TwoWire::hasDeviceId() {
+  /*!
+   * @brief   Check whether any memory on the bus answers the Device ID command
+   * @return  true if at least one memory has a Device ID
+   */
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    if (_Chips[i].address != 0 && _Chips[i].product != 0) return true;
+  }  // of for-next each slot
+  return false;
+}  // of method "hasDeviceId()"
+SimChip *TwoWire::findChip(const uint8_t address) {
+  /*!
+   * @brief     Return the memory answering on a slave address
+   * @param[in] address 7-bit I2C slave address
+   * @return    Pointer to the memory or nullptr if there is none
+   */
+  for (uint8_t i = 0; i < SIM_MAX_CHIPS; i++) {
+    if (_Chips[i].address != 0 && address >= _Chips[i].address &&
+        address < _Chips[i].address + _Chips[i].slaves) {
+      return &_Chips[i];
+    }  // of if-then slave address belongs to the memory
+  }  // of for-next each slot
+  return nullptr;
+}  // of method "findChip()"
+void TwoWire::countTransaction(const uint32_t addressBytes, const uint32_t payloadBytes,
+                               const bool sendStop) {
+  /*!
+   * @brief     Add one transaction to the bus counters
+   * @details   Every byte takes 9 clock cycles (8 data bits and the acknowledge bit), the START
+   *            condition and the optional STOP condition are counted as one clock cycle each
+   * @param[in] addressBytes Number of slave address and memory address bytes
+   * @param[in] payloadBytes Number of data bytes
+   * @param[in] sendStop Set when the transaction ends with a STOP condition
+   */
+  stats.transactions++;
+  stats.addressBytes += addressBytes;
+  stats.payloadBytes += payloadBytes;
+  stats.clocks += 9 * (addressBytes + payloadBytes) + 1 + (sendStop ? 1 : 0);
+}  // of method "countTransaction()"
@@ -0,0 +1,105 @@
+/*! @file Wire.h
+ @section Wire_intro_section Description
+
+ Host-side replacement for the Arduino "Wire" I2C library. The TwoWire class implements the subset
+ of the Arduino API used by the MB85_FRAM library and, instead of driving real hardware, simulates
+ up to 8 MB85RC memories at the I2C addresses 0x50 to 0x57. Each simulated memory has the correct
+ size and wraps around from its highest address back to 0 like the real parts do. Memories given a
+ product ID answer the Fujitsu Device ID command on the reserved slave address 0xF8. Memories of
+ 2kB and less take a single address byte and, as with the MB85RC1MT, the address bits which don't
+ fit into the address bytes are taken from the lowest bits of the slave address, so that these
+ memories answer on several consecutive slave addresses.\n\n
+
+ Every bus transaction is counted, split into address-phase bytes (slave address and memory
+ address) and payload bytes, and the number of SCL clock cycles used is accumulated so that the
+ bus time at any of the I2C_*_MODE speeds can be estimated. The transmit and receive buffers are
+ limited to BUFFER_LENGTH bytes as in the AVR implementation, bytes written past the end of the
+ transmit buffer are dropped and counted. Bus glitches can be simulated by letting every n-th
+ transaction to a memory fail without an acknowledge. A second bus "Wire1" with its own memories
+ and counters is available for multi-bus configurations.
+*/
+#ifndef TwoWire_h
+  /** @brief  Guard code to prevent multiple definitions */
+  #define TwoWire_h
+  #include <vector>  // Simulated memory contents
+
+  #include "Arduino.h"  // Arduino data type definitions
+  #ifndef BUFFER_LENGTH
+    /** @brief  Size of the Wire transmit and receive buffers */
+    #define BUFFER_LENGTH 32
+  #endif
+const uint8_t SIM_MAX_CHIPS{8};             ///< Number of simulated memories on one bus
+const uint8_t SIM_DEVICE_ID_ADDRESS{0x7C};  ///< Reserved Device ID address (0xF8 >> 1)
+
+/*! @brief  Bus usage counters accumulated by the simulated TwoWire class */
+struct I2CStats {
+  uint32_t transactions;  ///< Number of START and repeated START conditions
+  uint32_t addressBytes;  ///< Slave address and memory address bytes
+  uint32_t payloadBytes;  ///< Data bytes read or written
+  uint32_t naks;          ///< Transactions not acknowledged by any device
+  uint32_t dropped;       ///< Bytes lost because the transmit buffer was full
+  uint64_t clocks;        ///< SCL clock cycles used, including START and STOP
+};
+
+/*! @brief  One simulated MB85RC memory chip */
+struct SimChip {
+  uint8_t              address;       ///< First I2C slave address, 0 if unused
+  uint8_t              slaves;        ///< Number of slave addresses answered
+  uint8_t              addressBytes;  ///< Number of memory address bytes, 1 or 2
+  uint32_t             bytes;         ///< Memory size in bytes (power of 2)
+  uint16_t             product;       ///< 12 bit product ID, 0 if the memory has no Device ID
+  uint32_t             latch;         ///< Internal address counter
+  std::vector<uint8_t> memory;        ///< Memory contents
+};
+
+class TwoWire {
+  /*!
+   * @class   TwoWire
+   * @brief   Simulated I2C bus with attached MB85RC memories
+   */
+ public:
+  TwoWire();
+  void    begin();
+  void    setClock(const uint32_t clock);
+  void    beginTransmission(const uint8_t address);
+  void    beginTransmission(const int address);
+  size_t  write(const uint8_t data);
+  size_t  write(const uint8_t *data, const size_t quantity);
+  uint8_t endTransmission(const uint8_t sendStop = true);
+  uint8_t requestFrom(const uint8_t address, const uint8_t quantity);
+  uint8_t requestFrom(const int address, const int quantity);
+  int     available();
+  int     read();
+  int     peek();
+  /*************************************************************************************************
+  ** Simulator methods, these are not part of the Arduino API                                     **
+  *************************************************************************************************/
+  bool     attachChip(const uint8_t address, const uint32_t bytes, const uint16_t product = 0);
+  void     detachAll();
+  uint8_t *chipMemory(const uint8_t address, uint32_t *bytes = nullptr);
+  void     resetStats();
+  double   busMicros(const uint32_t clock) const;
+  uint32_t getClock() const;
+  void     injectNaks(const uint32_t period);
+  I2CStats stats;  ///< Accumulated bus usage counters
+
+ private:
+  SimChip *findChip(const uint8_t address);
+  bool     hasDeviceId();
+  void     countTransaction(const uint32_t addressBytes, const uint32_t payloadBytes,
+                            const bool sendStop);
+  SimChip  _Chips[SIM_MAX_CHIPS];     ///< Attached memories
+  uint32_t _Clock;                    ///< Current bus clock in Hz
+  uint8_t  _TxAddress;                ///< Slave address of the open transmission
+  uint8_t  _TxBuffer[BUFFER_LENGTH];  ///< Transmit buffer
+  uint8_t  _TxLength;                 ///< Bytes in the transmit buffer
+  uint8_t  _RxBuffer[BUFFER_LENGTH];  ///< Receive buffer
+  uint8_t  _RxLength;                 ///< Bytes in the receive buffer
+  uint8_t  _RxIndex;                  ///< Next byte to return from the receive buffer
+  uint8_t  _IdAddress;                ///< Slave address selected for the Device ID command
+  uint32_t _NakPeriod;                ///< Every n-th memory transaction fails, 0 for none
+  uint32_t _NakCount;                 ///< Memory transactions since the last injected failure
+};  // of class TwoWire
+extern TwoWire Wire;   ///< Default bus instance, as in the Arduino library
+extern TwoWire Wire1;  ///< Second bus instance, as on boards with more than one I2C bus
+#endif
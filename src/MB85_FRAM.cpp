@@ -6,12 +6,51 @@ See main library header file for details
 */
 #include "MB85_FRAM.h"  // Include the header definition
 
-MB85_FRAM_Class::MB85_FRAM_Class() {
+uint16_t MB85_crc16(const uint8_t *data, const uint32_t length, uint16_t crc) {
   /*!
-   * @brief   Class constructor
-   * @details Currently empty and unused
+   * @brief     Compute the CRC-16/CCITT of a block of bytes
+   * @details   Polynomial 0x1021, computed bit by bit to avoid a 512 byte table
+   * @param[in] data Bytes to check
+   * @param[in] length Number of bytes
+   * @param[in] crc Start value, 0xFFFF or the result of a previous block to continue it
+   * @return    CRC value
    */
-}
+  for (uint32_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }  // of for-next each byte
+  return crc;
+}  // of function "MB85_crc16()"
+
+MB85_FRAM_Class::MB85_FRAM_Class(TwoWire &bus) {
+  /*!
+   * @brief     Class constructor for memories on a single I2C bus
+   * @param[in] bus I2C bus the memories are attached to, defaults to "Wire"
+   */
+  _Bus[0]   = &bus;
+  _BusCount = 1;
+}  // of class constructor
+MB85_FRAM_Class::MB85_FRAM_Class(TwoWire &bus0, TwoWire &bus1) {
+  /*!
+   * @brief     Class constructor for memories on two I2C buses
+   * @details   The second bus is ignored when MB85_FRAM_BUSES is 1
+   * @param[in] bus0 First I2C bus, e.g. "Wire"
+   * @param[in] bus1 Second I2C bus, e.g. "Wire1"
+   */
+  _Bus[0]   = &bus0;
+  _BusCount = 1;
+  if (MB85_MAX_BUSES > 1) _Bus[_BusCount++] = &bus1;  // Ignored if built for a single bus
+}  // of class constructor
+MB85_FRAM_Class::MB85_FRAM_Class(TwoWire *const buses[], const uint8_t busCount) {
+  /*!
+   * @brief     Class constructor for memories on several I2C buses
+   * @details   Buses past MB85_MAX_BUSES are ignored
+   * @param[in] buses Array of pointers to the I2C buses
+   * @param[in] busCount Number of entries in "buses"
+   */
+  _BusCount = busCount < MB85_MAX_BUSES ? busCount : MB85_MAX_BUSES;
+  for (uint8_t i = 0; i < _BusCount; i++) _Bus[i] = buses[i];
+}  // of class constructor
 MB85_FRAM_Class::~MB85_FRAM_Class() {
   /*!
    * @brief   Class destructor
@@ -25,145 +64,880 @@ uint32_t MB85_FRAM_Class::totalBytes() {
    */
   return _TotalMemory;
 }  // method "totalBytes()"
-uint8_t MB85_FRAM_Class::begin(const uint32_t i2cSpeed) {
+uint8_t MB85_FRAM_Class::begin(const uint32_t i2cSpeed, const MB85_Mapping mapping) {
   /*!
     @brief   starts communications with the device
-    @details There are 4 possible memory sizes, 8kB, 16kB, 32kB, and 64kB and this function will
-             automatically determine the size of each memory found. The memories will wrap around
-             from the highest-address back to 0 on reads/writes and the detection process makes use
-             of this feature. The contents of memory address 0 is saved and overwritten with 0x00.
-             Then, starting with the smallest memory, the value of the highest value for that memory
-             plus 1 is stored and written as 0xFF. If address 0 has changed to 0xFF then we know
-             we've had a wrap-around and have identified the chip, otherwise we repeat the procedure
-             for the next possible memory size address and so on.
+    @details Each of the 8 possible I2C addresses on each bus is checked for a memory. The
+             MB85RC256V, MB85RC512T and MB85RC1MT report their size through the Fujitsu Device ID
+             command, which takes a single write and read on the reserved slave address 0xF8. The
+             memories with 1 address byte are recognised by probeShortAddress() and the other
+             memories are sized by probeSize(), which makes use of the memories wrapping around
+             from the highest address back to 0 on reads and writes. The slave addresses taken up
+             by the upper memory address bits of a memory are skipped.
   @param[in] i2cSpeed I2C Bus speed in Herz
+  @param[in] mapping How the memory on several buses is combined, see buildTable()
   @return    Number of MB85 devices detected
   */
-  Wire.begin();
-  Wire.setClock(i2cSpeed);
-  for (uint8_t i = MB85_MIN_ADDRESS; i < MB85_MIN_ADDRESS + 8; i++)  // loop all possible addresses
-  {
-    Wire.beginTransmission(i);
-    if (Wire.endTransmission() == 0)  // If no error we have a device at this address
-    {
-      for (uint16_t memSize = 8192; memSize != 0; memSize = memSize * 2)  // Check each memory size
-      {
-        // Read the contents of address 0 and store into "minimumByte"
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)0);                        // Start at MSB address 0
-        Wire.write((uint8_t)0);                        // Start at LSB address 0
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-        Wire.requestFrom(i, (uint8_t)1);               // Request 1 byte of data
-        uint8_t minimumByte = Wire.read();             // Store value of byte 0
-
-        // Write 0xFF to address 0
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)0);                        // Start at MSB address 0
-        Wire.write((uint8_t)0);                        // Start at LSB address 0
-        Wire.write(0xFF);                              // write high value to address 0
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-
-        // Read the value at address "memSize" to "maximumByte"
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)(memSize >> 8));           // Write MSB of address
-        Wire.write((uint8_t)memSize);                  // Write LSB of address
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-        Wire.requestFrom(i, (uint8_t)1);               // Request 1 byte of data
-        uint8_t maximumByte = Wire.read();             // Store value of high byte for chip
-
-        // Write a 0x00 to address "memSize"
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)(memSize >> 8));           // Write MSB of address
-        Wire.write((uint8_t)memSize);                  // Write LSB of address
-        Wire.write(0x00);                              // write low value to max address
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-
-        // Read the value at 0x00
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)0);                        // Start at MSB address 0
-        Wire.write((uint8_t)0);                        // Start at LSB address 0
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-        Wire.requestFrom(i, (uint8_t)1);               // Request 1 byte of data
-        uint8_t newMinimumByte = Wire.read();          // Store value of byte 0
-
-        // Write the original value back to memory
-        Wire.beginTransmission(i);                     // Start transmission
-        Wire.write((uint8_t)(memSize >> 8));           // Write MSB of address
-        Wire.write((uint8_t)memSize);                  // Write LSB of address
-        Wire.write(maximumByte);                       // restore original value
-        _TransmissionStatus = Wire.endTransmission();  // Close transmission
-
-        if (newMinimumByte != 0xFF)                      // Check if the value has changed
-        {                                                //
-          _I2C[i - MB85_MIN_ADDRESS] = memSize / 1024;   // Store memory size in kB
-          _TotalMemory += memSize;                       // Add value to total
-          Wire.beginTransmission(i);                     // Start transmission
-          Wire.write((uint8_t)0);                        // Write MSB of address
-          Wire.write((uint8_t)0);                        // Write LSB of address
-          Wire.write(minimumByte);                       // restore original value
-          _TransmissionStatus = Wire.endTransmission();  // Close transmission
-          break;                                         // Exit the loop
-        }                                                // of if-then we've got a wraparound
-      }                                                  // of for-next loop for each memory size
-      _DeviceCount++;                                    // Increment the found count
-    }                                                    // of if-then we have found a device
-  }                                                      // of for-next each I2C address loop
-  return _DeviceCount;                                   // return number of memories found
+  MB85_Type types[MB85_MAX_CHIPS] = {};  // Memory at each slave address, 8 per bus
+  startBuses(i2cSpeed);
+  for (uint8_t b = 0; b < _BusCount; b++) {           // loop all buses
+    TwoWire &bus   = *_Bus[b];                        // Bus to search
+    uint8_t  found = 0;                               // Bit mask of acknowledging addresses
+    for (uint8_t i = 0; i < MB85_MAX_DEVICES; i++) {  // loop all possible addresses
+      bus.beginTransmission(MB85_MIN_ADDRESS + i);
+      if (bus.endTransmission() == 0) found |= 1 << i;  // If no error we have a device
+    }                                                   // of for-next each I2C address
+    for (uint8_t i = 0; i < MB85_MAX_DEVICES; i++) {
+      if ((found & (1 << i)) == 0) continue;                         // No device at this address
+      uint32_t memSize = readDeviceID(bus, MB85_MIN_ADDRESS + i);    // Try the Device ID first
+      if (memSize == 0) memSize = probeShortAddress(bus, i, found);  // then 1 address byte
+      if (memSize == 0) memSize = probeSize(bus, MB85_MIN_ADDRESS + i);  // otherwise probe
+      uint8_t bits = 0;                                                  // log2 of memory size
+      while ((1UL << bits) < memSize) bits++;
+      types[b * MB85_MAX_DEVICES + i] = (MB85_Type)bits;  // Type is log2 of memory size
+      i += MB85_slaveCount((MB85_Type)bits) - 1;          // Skip the upper address bits
+    }                                                     // of for-next each I2C address
+  }                                                       // of for-next each bus
+  buildTable(types, mapping);                             // Build address translation table
+  return _DeviceCount;                                    // return number of memories found
 }  // of method begin()
+uint8_t MB85_FRAM_Class::begin(const MB85_Type layout[MB85_MAX_DEVICES], const uint32_t i2cSpeed,
+                               const MB85_Mapping mapping) {
+  /*!
+    @brief   starts communications with a known set of devices
+    @details The memory type at each of the 8 I2C addresses is given in "layout" and no probing of
+             the I2C bus is done at all, so the memories are ready for use immediately. With more
+             than one bus the layout holds 8 entries for each bus in turn. The entries for the
+             slave addresses taken up by the upper address bits of an MB85RC1MT, MB85RC04V or
+             MB85RC16 are ignored and should be MB85_NONE.
+  @param[in] layout Memory type at each I2C address from MB85_MIN_ADDRESS, MB85_NONE if absent
+  @param[in] i2cSpeed I2C Bus speed in Herz
+  @param[in] mapping How the memory on several buses is combined, see buildTable()
+  @return    Number of MB85 devices in the layout
+  */
+  startBuses(i2cSpeed);
+  buildTable(layout, mapping);  // Build address translation table
+  return _DeviceCount;          // return number of memories
+}  // of method begin()
+void MB85_FRAM_Class::startBuses(const uint32_t i2cSpeed) {
+  /*!
+    @brief    Start all I2C buses at the given speed
+    @param[in] i2cSpeed I2C Bus speed in Herz
+  */
+  for (uint8_t b = 0; b < _BusCount; b++) {
+    _Bus[b]->begin();
+    _Bus[b]->setClock(i2cSpeed);
+  }  // of for-next each bus
+  _Clock = i2cSpeed;
+}  // of internal method startBuses()
+uint32_t MB85_FRAM_Class::readDeviceID(TwoWire &bus, const uint8_t address) {
+  /*!
+    @brief    Read the Fujitsu Device ID of a memory
+    @details  The slave address of the memory is written to the reserved slave address 0xF8 and
+              then 3 bytes are read back after a repeated start. These contain the 12 bit
+              manufacturer ID (0x00A for Fujitsu) and the 12 bit product ID, the upper 4 bits of
+              which give the memory density
+    @param[in] bus I2C bus of the memory
+    @param[in] address I2C address of the memory
+    @return   Memory size in bytes, 0 if the memory has no valid Device ID
+  */
+  bus.beginTransmission(MB85_DEVICE_ID_ADDRESS);  // Reserved Device ID address
+  bus.write((uint8_t)(address << 1));             // Select the memory
+  if (bus.endTransmission(false) != 0) return 0;  // No device supports the ID
+  if (bus.requestFrom(MB85_DEVICE_ID_ADDRESS, (uint8_t)3) != 3) return 0;  // Read 3 byte ID
+  uint8_t  id[3]        = {(uint8_t)bus.read(), (uint8_t)bus.read(), (uint8_t)bus.read()};
+  uint16_t manufacturer = ((uint16_t)id[0] << 4) | (id[1] >> 4);  // 12 bit manufacturer ID
+  uint8_t  density      = id[1] & 0x0F;                           // upper 4 bits of product ID
+  if (manufacturer != MB85_MANUFACTURER_ID) return 0;             // Not a Fujitsu ID
+  if (density < MB85_MIN_DENSITY || density > MB85_MAX_DENSITY) return 0;  // Unsupported size
+  return 1UL << (density + 10);                                            // Density 5 is 32kB
+}  // of internal method readDeviceID()
+uint32_t MB85_FRAM_Class::probeSize(TwoWire &bus, const uint8_t address) {
+  /*!
+    @brief    Determine the size of a memory without a Device ID
+    @details  The memories wrap around from the highest address back to 0, so for each possible
+              memory size the byte at that address is compared to the byte at address 0. If they
+              differ the memory is larger, otherwise the byte is inverted and if address 0 changes
+              as well the memory size has been found. The inverted byte is always written back, so
+              the memory contents are left unchanged.
+    @param[in] bus I2C bus of the memory
+    @param[in] address I2C address of the memory
+    @return   Memory size in bytes
+  */
+  uint8_t firstByte = readByte(bus, address, 0);                      // Value at address 0
+  for (uint32_t memSize = 8192; memSize < 65536; memSize *= 2) {      // Check each memory size
+    if (readByte(bus, address, memSize) != firstByte) continue;       // Different, so not wrapped
+    writeByte(bus, address, memSize, ~firstByte);                     // Change the possible alias
+    bool wrapped = readByte(bus, address, 0) == (uint8_t)~firstByte;  // Check if address 0 changed
+    writeByte(bus, address, memSize, firstByte);                      // restore original value
+    if (wrapped) return memSize;  // Exit if we've got a wraparound
+  }                               // of for-next each memory size
+  return 65536;                   // Largest 2 byte address memory
+}  // of internal method probeSize()
+uint32_t MB85_FRAM_Class::probeShortAddress(TwoWire &bus, const uint8_t slot, const uint8_t found) {
+  /*!
+    @brief    Check for a memory with 1 address byte
+    @details  An MB85RC04V takes up an even slave address and the following one, an MB85RC16 all 8,
+              so only an even slave address followed by another one can be such a memory. The
+              check never relies on the memory contents, as a byte read from the wrong address can
+              hold any value. Byte "a" is read at address 0 with a 1 byte address and used as the
+              low byte of a 2 byte address 0x00aa, so that a 2 byte read and write of 0x00aa only
+              rewrite byte 0 with its own value on a memory with 1 address byte. The byte "b" at
+              0x00aa, which is byte 1 on such a memory, is then written inverted and afterwards
+              restored with 2 byte addresses and read back with a 1 byte address after each write.
+              A memory with 1 address byte returns the marker and then the restored value, while a
+              memory with 2 address bytes ignores the incomplete 1 byte address and returns the
+              byte following 0x00aa both times, which can't match both. The same two markers are
+              then read from the end of the second 256 byte page, where the address counter of the
+              MB85RC04V wraps back to address 0 while that of the MB85RC16 continues to 0x200.
+    @param[in] bus I2C bus of the memory
+    @param[in] slot Slave address offset from MB85_MIN_ADDRESS
+    @param[in] found Bit mask of the slave address offsets which acknowledged
+    @return   Memory size in bytes, 0 if the memory doesn't have 1 address byte
+  */
+  if ((slot & 1) || (found & (2 << slot)) == 0) return 0;  // Needs an even and odd address
+  uint8_t address = MB85_MIN_ADDRESS + slot;               // Slave address of the memory
+  uint8_t first, marker[2], check[2], wrapped[2], status;  // Markers are "b" inverted and "b"
+  transferI2C(bus, address, MB85RC04V, 0, MB85_READ, &first, 0, 1, true, status);
+  transferI2C(bus, address, MB85RC64, first, MB85_READ, &marker[1], 0, 1, true, status);
+  marker[0] = ~marker[1];            // Changes every bit of "b"
+  for (uint8_t i = 0; i < 2; i++) {  // Write the marker, then restore "b"
+    transferI2C(bus, address, MB85RC64, first, MB85_WRITE, &marker[i], 0, 1, true, status);
+    transferI2C(bus, address, MB85RC04V, 1, MB85_READ, &check[i], 0, 1, true, status);
+    if (i == 0 && check[i] != marker[i]) break;  // Not a 1 byte address, "b" still to restore
+    bus.beginTransmission(address + 1);          // Second page of the memory
+    bus.write((uint8_t)0xFF);                    // Last byte of the page
+    bus.endTransmission();
+    bus.requestFrom(address + 1, 3);  // Read across the end of the page
+    bus.read();                       // Last byte of the page
+    bus.read();                       // Byte 0 or 0x200
+    wrapped[i] = bus.read();          // Byte 1 or 0x201
+  }                                   // of for-next each marker
+  if (check[0] != marker[0]) {
+    transferI2C(bus, address, MB85RC64, first, MB85_WRITE, &marker[1], 0, 1, true, status);
+    return 0;  // Memory has 2 address bytes
+  }            // of if-then not a 1 byte address
+  if (check[1] != marker[1]) return 0;  // Not a memory with 1 address byte after all
+  if (wrapped[0] == marker[0] && wrapped[1] == marker[1]) return MB85_typeBytes(MB85RC04V);
+  if (slot == 0 && found == 0xFF) return MB85_typeBytes(MB85RC16);  // Uses all slave addresses
+  return 0;  // Not a memory with 1 address byte after all
+}  // of internal method probeShortAddress()
+uint8_t MB85_FRAM_Class::readByte(TwoWire &bus, const uint8_t address, const uint16_t memAddr) {
+  /*!
+    @brief    Read a single byte from a memory during detection
+    @param[in] bus I2C bus of the memory
+    @param[in] address I2C address of the memory
+    @param[in] memAddr Memory address on the device
+    @return   Byte read
+  */
+  bus.beginTransmission(address);               // Address the I2C device
+  bus.write((uint8_t)(memAddr >> 8));           // Send MSB register address
+  bus.write((uint8_t)memAddr);                  // Send LSB address to read
+  _TransmissionStatus = bus.endTransmission();  // Close transmission
+  bus.requestFrom(address, (uint8_t)1);         // Request 1 byte of data
+  return bus.read();                            // return the byte
+}  // of internal method readByte()
+void MB85_FRAM_Class::writeByte(TwoWire &bus, const uint8_t address, const uint16_t memAddr,
+                                const uint8_t value) {
+  /*!
+    @brief    Write a single byte to a memory during detection
+    @param[in] bus I2C bus of the memory
+    @param[in] address I2C address of the memory
+    @param[in] memAddr Memory address on the device
+    @param[in] value Byte to write
+  */
+  bus.beginTransmission(address);               // Address the I2C device
+  bus.write((uint8_t)(memAddr >> 8));           // Send MSB register address
+  bus.write((uint8_t)memAddr);                  // Send LSB address to write
+  bus.write(value);                             // Send the data byte
+  _TransmissionStatus = bus.endTransmission();  // Close transmission
+}  // of internal method writeByte()
+void MB85_FRAM_Class::buildTable(const MB85_Type types[], const MB85_Mapping mapping,
+                                 const uint8_t pins[], const uint8_t pinCount) {
+  /*!
+    @brief   Build the tables used to translate a memory address to a device
+    @details The memories found are numbered by bus and then in order of their I2C address and the
+             start of each one in this "linear" memory space is stored, followed by its total
+             size, as is the start of each bus. The linear space is then split into MB85_GRANULES
+             equal power-of-2 sized granules and for each granule the first memory it contains is
+             stored, so that finding the device for an address is a single table lookup. If all
+             memories are of the same size then the device is found with a shift instead. Without
+             the granule table, i.e. MB85_FRAM_GRANULES is 0, the memories are searched in order.\n
+             With MB85_CONTIGUOUS the memory addresses are the linear addresses. With MB85_STRIPED
+             the memory addresses are split into 256 byte stripes which are spread over the buses
+             in turn, so that large transfers keep all buses busy. This only uses as much memory
+             on each bus as the bus with the least memory has, and falls back to MB85_CONTIGUOUS
+             if a bus has no memory at all.\n
+             Memories which aren't on an I2C bus, e.g. those of MB85_FRAM_SPI_Class, are found
+             by their pin in "pins" instead of by their slave address.
+    @param[in] types Memory type at each slave address or pin, 8 entries for each bus
+    @param[in] mapping How the memory on several buses is combined
+    @param[in] pins Pin of each memory slot, nullptr for memories on I2C buses
+    @param[in] pinCount Number of entries in "pins"
+  */
+  _DeviceCount   = 0;                                    // Reset the count of memories
+  uint32_t total = 0;                                    // and the linear memory size
+  _ChipShift     = 0;                                    // Assume the memories differ
+  uint8_t  slots = pins ? pinCount : MB85_MAX_DEVICES;   // I2C addresses or pins per bus
+  for (uint8_t b = 0; b < _BusCount; b++) {              // Loop through each bus
+    _BusStart[b] = total;                                // Store the start of the bus
+    for (uint8_t i = 0; i < slots; i++) {                // Loop through each possible device
+      MB85_Type type = types[b * MB85_MAX_DEVICES + i];  // Memory type at the address
+      if (type) {                                        // If there's a memory at address
+        _ChipAddress[_DeviceCount] = pins ? pins[i] : MB85_MIN_ADDRESS + i;
+        _ChipBus[_DeviceCount]     = b;             // and the bus
+        _ChipType[_DeviceCount]    = type;          // and the type
+        _ChipStart[_DeviceCount++] = total;         // Store the start address
+        total += MB85_typeBytes(type);              // Add value to total
+        if (!pins) i += MB85_slaveCount(type) - 1;  // Skip the upper address bits
+      }                                             // of if-then memory found
+    }                                               // of for-next each device
+  }                                                 // of for-next each bus
+  _BusStart[_BusCount]     = total;                         // Last entry is the linear size
+  _ChipStart[_DeviceCount] = total;                         // Last entry is the linear size
+  _TotalMemory             = total;                         // Contiguous unless striped
+  _Striped                 = mapping == MB85_STRIPED && _BusCount > 1;
+  uint32_t busMemory       = UINT32_MAX;  // Least memory on any bus
+  for (uint8_t b = 0; b < _BusCount; b++) {
+    if (_BusStart[b + 1] - _BusStart[b] < busMemory) busMemory = _BusStart[b + 1] - _BusStart[b];
+  }                                                      // of for-next each bus
+  if (busMemory == 0) _Striped = false;                  // Can't stripe over an empty bus
+  if (_Striped) _TotalMemory = busMemory * _BusCount;    // Equal share of each bus
+  if (_DeviceCount == 0) return;                         // Nothing more to do without memory
+  uint32_t chipSize = _ChipStart[1];                     // Size of the first memory
+  bool     allEqual = (chipSize & (chipSize - 1)) == 0;  // Size must be a power of 2
+  for (uint8_t i = 1; i < _DeviceCount; i++) {
+    if (_ChipStart[i + 1] - _ChipStart[i] != chipSize) allEqual = false;
+  }  // of for-next each memory
+  if (allEqual) {
+    while ((1UL << _ChipShift) < chipSize) _ChipShift++;  // Compute log2 of memory size
+  }                                                       // of if-then all memories equal
+#if MB85_FRAM_GRANULES > 0
+  _GranuleShift = 0;  // Find smallest usable granule
+  while (((total - 1) >> _GranuleShift) >= MB85_GRANULES) _GranuleShift++;
+  uint8_t chip = 0;
+  for (uint8_t i = 0; i < MB85_GRANULES; i++) {  // Store the memory at the start of each granule
+    while (chip + 1 < _DeviceCount && ((uint32_t)i << _GranuleShift) >= _ChipStart[chip + 1]) {
+      chip++;
+    }                    // of while granule starts past this memory
+    _Granule[i] = chip;  // Store the memory number
+  }                      // of for-next each granule
+#endif
+}  // of internal method buildTable()
 uint8_t MB85_FRAM_Class::getDevice(uint32_t &memAddress, uint32_t &endAddress) {
   /*!
     @brief      returns the device index for the given memory addres
-    @param[in]  memAddress Memory address to check
-    @param[out] endAddress end of memory chip
+    @details    The device is found with a shift when all memories are the same size, otherwise
+                from the granule table built in begin(). A granule only contains more than one
+                memory when memories smaller than the granule are present. Without the granule
+                table the memories are searched from the first one.
+    @param[in,out] memAddress Linear memory address to check, returned as the device memory address
+    @param[out] endAddress Last memory address on the device
     @return     device index number
   */
   uint8_t device = 0;
-  endAddress     = UINT32_MAX;  // Start at max so adding 1 = 0
-  for (device = 0; device < MB85_MAX_DEVICES; device++) {
-    if (_I2C[device])  // If there's a memory at address
-    {
-      endAddress += (uint32_t)_I2C[device] * 1024;  // Compute end of memory chip
-      if (endAddress >= memAddress) {
-        break;                                      // Exit if we are in range
-      }                                             // of if we need to exit loop
-      memAddress -= (uint32_t)_I2C[device] * 1024;  // adjust memory address
-    }                                               // of if we have a device at address
-  }                                                 // of for-next all possible devices
+  if (_ChipShift) {
+    device = memAddress >> _ChipShift;  // All memories are the same size
+  } else {
+#if MB85_FRAM_GRANULES > 0
+    device = _Granule[memAddress >> _GranuleShift];  // Look up first memory in granule
+#endif
+    while (memAddress >= _ChipStart[device + 1]) {
+      device++;
+    }                                // of while address is past this memory
+  }                                  // of if-then-else all memories the same size
+  memAddress -= _ChipStart[device];  // Address on the memory
+  endAddress = _ChipStart[device + 1] - _ChipStart[device] - 1;  // Last address on the memory
   return device;
 }  // of internal method getDevice()
 uint32_t MB85_FRAM_Class::memSize(const uint8_t memNumber) {
   /*!
     @brief    returns the device size in Bytes
-    @param[in]  memNumber Memory index
+    @param[in]  memNumber Memory index, memories are numbered by bus and then I2C address
     @return     Memory size in Bytes
   */
-  if (memNumber <= _DeviceCount) {
-    return ((uint32_t)_I2C[memNumber] * 1024);  // Return memory size
+  if (memNumber < _DeviceCount) {
+    return _ChipStart[memNumber + 1] - _ChipStart[memNumber];  // Return memory size
   } else {
     return 0;  // return 0 if out of range
   }            // of if-then-else device number in range
 }  // of method memSize()
-int8_t MB85_FRAM_Class::requestI2C(const uint8_t device, const uint32_t memAddr,
-                                   const uint16_t dataSize, const bool endTrans) {
-  /*!
-    @brief    Request I2C data
-    details   Method requestI2C() is an internal call used in the read() template to send the 2 byte
-              address and request a number of bytes to be read from that address. The "endTrans"
-              parameter specified whether or not to end the transmission. If specified then it is a
-              read call, otherwise it is a write and the data follows
-  @param[in]  device MB85 Device number
-  @param[in]  memAddr Memory address
-  @param[in]  dataSize Number of bytes
-  @param[in]  endTrans End transmission when set to "true"
-  @return     Number of bytes read
-  */
-  Wire.beginTransmission(device + MB85_MIN_ADDRESS);        // Address the I2C device
-  Wire.write(memAddr >> 8);                                 // Send MSB register address
-  Wire.write((uint8_t)memAddr);                             // Send LSB address to read
-  if (endTrans) {                                           // Read request, so end transmission
-    _TransmissionStatus = Wire.endTransmission();           // Close transmission
-    Wire.requestFrom(device + MB85_MIN_ADDRESS, dataSize);  // Request n-bytes of data
-    return Wire.available();                                // Return actual bytes read
-  }                 // of if-then endTransmission switch is set
-  return dataSize;  // Return the dataSize on write
-}  // of internal method requestI2C()
+uint32_t MB85_FRAM_Class::readBlock(const uint32_t addr, uint8_t *buffer, const uint32_t length) {
+  /*!
+    @brief     Read a block of bytes from memory
+    @details   Multiple memories are treated as one contiguous memory and the read wraps around from
+               the end of memory back to the beginning. The memory address is only sent once for
+               each memory chip read from, after that each I2C request reads as many bytes as fit
+               into the I2C buffer and the chip's internal address counter continues from where the
+               last request stopped.
+    @param[in] addr Memory address
+    @param[out] buffer Buffer to read to
+    @param[in] length Number of bytes to read
+    @return    Number of bytes read
+  */
+  MB85_Transfer transfer;  // Transfer state
+  setTransfer(transfer, MB85_READ, addr, buffer, length, 0, nullptr);
+  return runTransfer(transfer);  // return the number of bytes read
+}  // of method readBlock()
+uint32_t MB85_FRAM_Class::writeBlock(const uint32_t addr, const uint8_t *buffer,
+                                     const uint32_t length) {
+  /*!
+    @brief     Write a block of bytes to memory
+    @details   Multiple memories are treated as one contiguous memory and the write wraps around
+               from the end of memory back to the beginning. Each I2C transmission carries the 2
+               byte memory address followed by as many data bytes as fit into the I2C buffer.
+    @param[in] addr Memory address
+    @param[in] buffer Buffer to write from
+    @param[in] length Number of bytes to write
+    @return    Number of bytes written
+  */
+  MB85_Transfer transfer;  // Transfer state, the buffer is only read from
+  setTransfer(transfer, MB85_WRITE, addr, (uint8_t *)buffer, length, 0, nullptr);
+  return runTransfer(transfer);  // return the number of bytes written
+}  // of method writeBlock()
+uint32_t MB85_FRAM_Class::fill(const uint32_t addr, const uint32_t length, const uint8_t value) {
+  /*!
+    @brief     Fill a memory range with a single byte value
+    @details   No buffer is used, each I2C transmission carries the memory address followed by as
+               many copies of the value as fit into the I2C buffer, on SPI all bytes on a memory
+               are sent with one WRITE command. The fill wraps around at the end of memory.
+    @param[in] addr Memory address
+    @param[in] length Number of bytes to fill
+    @param[in] value Byte value to write
+    @return    Number of bytes written
+  */
+  MB85_Transfer transfer;  // Transfer state
+  setTransfer(transfer, MB85_FILL, addr, nullptr, length, value, nullptr);
+  return runTransfer(transfer);  // return the number of bytes written
+}  // of method fill()
+uint32_t MB85_FRAM_Class::fill(const uint32_t addr, const uint32_t length, const uint8_t *pattern,
+                               const uint8_t patternLength) {
+  /*!
+    @brief     Fill a memory range with copies of a pattern
+    @details   The pattern is repeated without gaps and the last copy is cut off at the end of the
+               range, so exactly "length" bytes are written. The copies are written from a bounce
+               buffer of MB85_BOUNCE_SIZE bytes, which holds at least one full I2C transmission, so
+               the number of transactions is the same as for a single byte value.
+    @param[in] addr Memory address
+    @param[in] length Number of bytes to fill
+    @param[in] pattern Bytes to repeat
+    @param[in] patternLength Number of bytes in the pattern, a length of 0 writes nothing
+    @return    Number of bytes written
+  */
+  if (patternLength == 0) return 0;                             // Nothing to repeat
+  if (patternLength == 1) return fill(addr, length, *pattern);  // No buffer needed
+  MB85_Transfer transfer;                                       // Transfer state
+  setTransfer(transfer, MB85_PATTERN, addr, (uint8_t *)pattern, length, patternLength, nullptr);
+  return runTransfer(transfer);  // return the number of bytes written
+}  // of method fill()
+uint32_t MB85_FRAM_Class::copy(const uint32_t source, const uint32_t destination,
+                               const uint32_t length) {
+  /*!
+    @brief     Copy a memory range to another memory address
+    @details   The ranges may overlap and may be on different memories, the copy behaves like
+               memmove(): when the destination lies in the source range the bytes are copied from
+               the end backwards, so that no byte is overwritten before it has been read. The bytes
+               are moved through a bounce buffer of MB85_BOUNCE_SIZE bytes on the stack, which is
+               read with one memory address and written back in full I2C transmissions. Both
+               ranges wrap around at the end of memory.
+    @param[in] source Memory address to copy from
+    @param[in] destination Memory address to copy to
+    @param[in] length Number of bytes to copy, limited to the total memory size
+    @return    Number of bytes copied
+  */
+  if (_TotalMemory == 0) return 0;                                 // No memory
+  uint32_t bytes = length < _TotalMemory ? length : _TotalMemory;  // Can't copy more than all
+  uint32_t from  = source % _TotalMemory;
+  uint32_t to    = destination % _TotalMemory;
+  uint32_t ahead = to >= from ? to - from : to + (_TotalMemory - from);  // Distance forwards
+  if (ahead == 0) return bytes;                                          // Copy onto itself
+  bool     backwards = ahead < bytes;  // Destination overlaps the end of the source
+  uint8_t  buffer[MB85_BOUNCE_SIZE];   // Bounce buffer
+  uint32_t done = 0;                   // Bytes copied
+  while (done < bytes) {
+    uint32_t chunk  = bytes - done > MB85_BOUNCE_SIZE ? MB85_BOUNCE_SIZE : bytes - done;
+    uint32_t offset = backwards ? bytes - done - chunk : done;  // Position in the range
+    if (readBlock(from + offset, buffer, chunk) != chunk) break;
+    if (writeBlock(to + offset, buffer, chunk) != chunk) break;
+    done += chunk;
+  }  // of while bytes left to copy
+  return done;
+}  // of method copy()
+uint32_t MB85_FRAM_Class::compare(const uint32_t addr, const uint8_t *buffer,
+                                  const uint32_t length) {
+  /*!
+    @brief     Compare a memory range with a buffer
+    @details   The memory is read in the same way as by readBlock(), with the memory address only
+               sent once for each memory, into a bounce buffer of MB85_BOUNCE_SIZE bytes and the
+               reading stops at the first difference. The range wraps around at the end of memory.
+    @param[in] addr Memory address
+    @param[in] buffer Buffer to compare with
+    @param[in] length Number of bytes to compare
+    @return    Offset of the first byte that differs, "length" if all bytes are equal, or
+               MB85_COMPARE_FAILED if a memory didn't respond before all bytes up to the first
+               difference were compared, in which case status() returns the status of the failed
+               transaction. With several buses the bytes aren't compared in address order, so the
+               failure is taken from the transfer rather than from the number of bytes compared.
+  */
+  MB85_Transfer transfer;  // Transfer state, the buffer is only read from
+  setTransfer(transfer, MB85_COMPARE, addr, (uint8_t *)buffer, length, 0, nullptr);
+  runTransfer(transfer);  // The length is cut at a difference
+  return transfer.failed ? MB85_COMPARE_FAILED : transfer.length;
+}  // of method compare()
+bool MB85_FRAM_Class::readAsync(const uint32_t addr, uint8_t *buffer, const uint32_t length,
+                                MB85_Callback callback) {
+  /*!
+    @brief     Queue a non-blocking read
+    @details   The read is performed by subsequent calls to poll(), the buffer must remain valid
+               until the callback has been called or pending() returns 0
+    @param[in] addr Memory address
+    @param[out] buffer Buffer to read to
+    @param[in] length Number of bytes to read
+    @param[in] callback Optional function called when the read has completed
+    @return    true if the read was queued, false if the queue is full or wasn't attached
+  */
+  return queueTransfer(MB85_READ, addr, buffer, length, 0, callback);
+}  // of method readAsync()
+bool MB85_FRAM_Class::writeAsync(const uint32_t addr, const uint8_t *buffer, const uint32_t length,
+                                 MB85_Callback callback) {
+  /*!
+    @brief     Queue a non-blocking write
+    @details   The write is performed by subsequent calls to poll(), the buffer must remain valid
+               and unchanged until the callback has been called or pending() returns 0
+    @param[in] addr Memory address
+    @param[in] buffer Buffer to write from
+    @param[in] length Number of bytes to write
+    @param[in] callback Optional function called when the write has completed
+    @return    true if the write was queued, false if the queue is full or wasn't attached
+  */
+  return queueTransfer(MB85_WRITE, addr, (uint8_t *)buffer, length, 0, callback);
+}  // of method writeAsync()
+bool MB85_FRAM_Class::fillAsync(const uint32_t addr, const uint32_t length, const uint8_t value,
+                                MB85_Callback callback) {
+  /*!
+    @brief     Queue a non-blocking fill of a memory range with a single byte value
+    @param[in] addr Memory address
+    @param[in] length Number of bytes to fill
+    @param[in] value Byte value to write
+    @param[in] callback Optional function called when the fill has completed
+    @return    true if the fill was queued, false if the queue is full or wasn't attached
+  */
+  return queueTransfer(MB85_FILL, addr, nullptr, length, value, callback);
+}  // of method fillAsync()
+void MB85_FRAM_Class::attachQueue(MB85_Transfer queue[], const uint8_t size) {
+  /*!
+    @brief     Provide the storage for the queue of asynchronous transfers
+    @details   The queue takes RAM for each entry, so it is only kept by sketches which use
+               readAsync(), writeAsync() or fillAsync(), which return false until it is attached.
+               Any transfers still queued are dropped without calling their callbacks.
+    @param[in] queue Array of transfers, e.g. of MB85_ASYNC_QUEUE entries, nullptr to detach it
+    @param[in] size Number of entries in "queue"
+  */
+  _Queue      = queue;
+  _QueueSize  = queue == nullptr ? 0 : size;
+  _QueueHead  = 0;
+  _QueueCount = 0;
+  for (uint8_t b = 0; b < MB85_MAX_BUSES; b++) _Latched[b] = nullptr;  // Forget queued transfers
+}  // of method attachQueue()
+bool MB85_FRAM_Class::poll() {
+  /*!
+    @brief     Advance the queued asynchronous transfers
+    @details   Each call performs at most one I2C transaction of up to BUFFER_LENGTH bytes on each
+               bus (two when a read has to send the memory address first, plus any retries of a
+               failed transaction as set by setRetries()), or one SPI transaction
+               of up to MB85_SPI_POLL_BYTES bytes, so the time spent in poll() is bounded
+               regardless of the transfer sizes. On each bus the oldest transfer with bytes left on
+               that bus is advanced, so a single large transfer keeps all buses busy. When a
+               transfer completes or a memory stops responding the transfer is removed from the
+               queue and its callback is called with the number of bytes done, transfers complete
+               in the order they were queued.
+    @return    true while transfers are still pending
+  */
+  if (_QueueCount == 0) return false;            // Nothing to do
+  for (uint8_t b = 0; b < _BusCount; b++) {      // One transaction on each bus
+    for (uint8_t i = 0; i < _QueueCount; i++) {  // Find the oldest transfer for the bus
+      MB85_Transfer &transfer = _Queue[(_QueueHead + i) % _QueueSize];
+      seekBus(transfer, b);                        // Skip bytes on other buses
+      if (transfer.offset[b] < transfer.length) {  // Transfer has bytes on this bus
+        transferChunk(transfer, b, false);         // Perform one transaction
+        break;                                     // and move on to the next bus
+      }                                            // of if-then bytes on this bus
+    }                                              // of for-next each queued transfer
+  }                                                // of for-next each bus
+  while (_QueueCount != 0 && finished(_Queue[_QueueHead])) {
+    MB85_Transfer &transfer = _Queue[_QueueHead];  // Oldest transfer has finished
+    for (uint8_t b = 0; b < _BusCount; b++) {
+      if (_Latched[b] == &transfer) _Latched[b] = nullptr;  // Slot will be reused
+    }                                                       // of for-next each bus
+    _QueueHead = (_QueueHead + 1) % _QueueSize;             // Remove it from the queue
+    _QueueCount--;                                          // before the callback can queue
+    if (transfer.callback != nullptr) transfer.callback(transfer.buffer, transfer.done);
+  }                         // of while oldest transfer finished
+  return _QueueCount != 0;  // return true while busy
+}  // of method poll()
+uint8_t MB85_FRAM_Class::pending() {
+  /*!
+    @brief     Return the number of queued asynchronous transfers
+    @return    Number of transfers not yet completed, including the active one
+  */
+  return _QueueCount;
+}  // of method pending()
+uint8_t MB85_FRAM_Class::status() {
+  /*!
+    @brief     Return the status of the last I2C transaction
+    @details   The status is that of Wire.endTransmission(), 0 on success, 2 or 3 if the address or
+               data weren't acknowledged and 4 or 5 for other errors, or MB85_NO_DATA if a read
+               returned no bytes. A transaction which succeeded on a retry returns 0.
+    @return    Status of the last transaction
+  */
+  return _TransmissionStatus;
+}  // of method status()
+void MB85_FRAM_Class::setRetries(const uint8_t retries) {
+  /*!
+    @brief     Set how often a failed I2C transaction is repeated before the transfer is ended
+    @details   The transfer methods return the number of bytes actually transferred, so a transfer
+               which still fails after all retries returns less than its length
+    @param[in] retries Number of repeats, MB85_RETRIES by default and 0 to disable
+  */
+  _Retries = retries;
+}  // of method setRetries()
+void MB85_FRAM_Class::attachStats(MB85_Stats stats[]) {
+  /*!
+    @brief     Start keeping bus usage counters for each memory
+    @details   The counters are cleared, the array needs one entry for each memory found by begin()
+               in the same order as for memSize()
+    @param[in] stats Array of counters, nullptr to stop counting
+  */
+  _Stats = stats;
+  if (_Stats != nullptr) memset(_Stats, 0, _DeviceCount * sizeof(MB85_Stats));
+}  // of method attachStats()
+uint32_t MB85_FRAM_Class::busMicros(const uint8_t memNumber) {
+  /*!
+    @brief     Return the bus time used by a memory since attachStats() was called
+    @param[in] memNumber Memory number, in the same order as for memSize()
+    @return    Bus time in microseconds rounded down, 0 if no counters are kept
+  */
+  if (_Stats == nullptr || memNumber >= _DeviceCount || _Clock == 0) return 0;
+  return (uint32_t)(_Stats[memNumber].clocks * 1000000 / _Clock);
+}  // of method busMicros()
+void MB85_FRAM_Class::setTransfer(MB85_Transfer &transfer, const MB85_Operation operation,
+                                  const uint32_t addr, uint8_t *buffer, const uint32_t length,
+                                  const uint8_t value, MB85_Callback callback) {
+  /*!
+    @brief     Initialize the state of a transfer
+    @param[out] transfer Transfer to initialize
+    @param[in] operation Read, write or fill
+    @param[in] addr Memory address, wrapped around to the memory size
+    @param[in] buffer Buffer to read to or write from, nullptr for a fill
+    @param[in] length Number of bytes
+    @param[in] value Byte value for a fill
+    @param[in] callback Completion callback, may be nullptr
+  */
+  transfer.address   = _TotalMemory == 0 || addr < _TotalMemory ? addr : addr % _TotalMemory;
+  transfer.buffer    = buffer;
+  transfer.length    = _TotalMemory == 0 ? 0 : length;  // No memory, so nothing to do
+  transfer.done      = 0;
+  transfer.callback  = callback;
+  transfer.operation = operation;
+  transfer.value     = value;
+  transfer.failed    = false;
+  for (uint8_t b = 0; b < MB85_MAX_BUSES; b++) {
+    transfer.offset[b] = 0;              // Every bus starts at the first byte
+    transfer.latch[b]  = MB85_NO_LATCH;  // and has to send the memory address
+  }                                      // of for-next each bus
+}  // of internal method setTransfer()
+bool MB85_FRAM_Class::queueTransfer(const MB85_Operation operation, const uint32_t addr,
+                                    uint8_t *buffer, const uint32_t length, const uint8_t value,
+                                    MB85_Callback callback) {
+  /*!
+    @brief     Add a transfer to the end of the asynchronous queue
+    @param[in] operation Read, write or fill
+    @param[in] addr Memory address
+    @param[in] buffer Buffer to read to or write from, nullptr for a fill
+    @param[in] length Number of bytes
+    @param[in] value Byte value for a fill
+    @param[in] callback Completion callback, may be nullptr
+    @return    true if the transfer was queued, false if the queue is full or wasn't attached
+  */
+  if (_QueueCount >= _QueueSize) return false;  // Queue is full or not attached
+  MB85_Transfer &transfer = _Queue[(_QueueHead + _QueueCount) % _QueueSize];
+  setTransfer(transfer, operation, addr, buffer, length, value, callback);
+  _QueueCount++;
+  return true;
+}  // of internal method queueTransfer()
+uint32_t MB85_FRAM_Class::seekBus(MB85_Transfer &transfer, const uint8_t bus) {
+  /*!
+    @brief     Skip the next bytes of a transfer which are not on the given bus
+    @details   The bytes of a transfer on one bus always form one or more runs, either one run per
+               pass through the bus's memory when contiguous or one run per stripe when striped.
+               The position of the bus in the transfer is moved to the start of the next run if it
+               isn't in one, or to the end of the transfer if there are no more bytes on the bus.
+    @param[in,out] transfer Transfer to update
+    @param[in] bus Bus number
+    @return    Memory address of the next byte on the bus
+  */
+  uint32_t offset = transfer.offset[bus];        // Next byte of the transfer on the bus
+  if (offset >= transfer.length) return 0;       // Bus has finished
+  uint32_t address = transfer.address + offset;  // Memory address of the byte
+  if (address >= _TotalMemory) address %= _TotalMemory;
+  uint32_t skip = 0;  // Bytes to skip to get to the bus
+  if (_Striped) {
+    uint8_t stripes = (bus + _BusCount - (address >> MB85_STRIPE_SHIFT) % _BusCount) % _BusCount;
+    if (stripes) {  // Address is on another bus
+      skip = ((uint32_t)stripes << MB85_STRIPE_SHIFT) - (address & (MB85_STRIPE_SIZE - 1));
+    }  // of if-then another bus
+  } else if (_BusStart[bus] == _BusStart[bus + 1]) {
+    skip = transfer.length - offset;  // No memory on this bus
+  } else if (address < _BusStart[bus]) {
+    skip = _BusStart[bus] - address;  // Bus comes later in memory
+  } else if (address >= _BusStart[bus + 1]) {
+    skip = _TotalMemory - address + _BusStart[bus];  // Bus comes after the wraparound
+  }                                                  // of if-then-else striped
+  if (skip == 0) return address;                     // Already on the bus
+  transfer.offset[bus] = skip < transfer.length - offset ? offset + skip : transfer.length;
+  address += skip;                                       // Move to the start of the run
+  if (address >= _TotalMemory) address %= _TotalMemory;  // Wrap around at the end of memory
+  return address;
+}  // of internal method seekBus()
+bool MB85_FRAM_Class::finished(MB85_Transfer &transfer) {
+  /*!
+    @brief     Check whether all bytes of a transfer have been transferred on every bus
+    @param[in,out] transfer Transfer to check
+    @return    true if the transfer has finished
+  */
+  for (uint8_t b = 0; b < _BusCount; b++) {
+    seekBus(transfer, b);  // Skip any bytes not on the bus
+    if (transfer.offset[b] < transfer.length) return false;
+  }  // of for-next each bus
+  return true;
+}  // of internal method finished()
+uint32_t MB85_FRAM_Class::transferChunk(MB85_Transfer &transfer, const uint8_t bus,
+                                        const bool stream) {
+  /*!
+    @brief     Perform the next I2C or SPI transaction of a transfer on one bus
+    @details   This is the single place where data is moved, used by both the blocking and the
+               asynchronous methods. One chunk never crosses a memory chip or stripe boundary and is
+               limited to the I2C buffer size. A read only sends the memory address for the first
+               chunk on each chip, further chunks continue from the chip's internal address counter
+               unless another transfer has used the bus in the meantime. If the memory doesn't
+               respond the transfer is ended. An SPI chunk has no buffer limit, so when streaming
+               all bytes on the chip are moved in one command, otherwise MB85_SPI_POLL_BYTES.
+               Pattern fills and compares go through a bounce buffer of MB85_BOUNCE_SIZE bytes, a
+               compare is read like a read and cuts the transfer length at the first difference.
+               A failed I2C transaction is repeated up to _Retries times by transferI2C().
+    @param[in,out] transfer Transfer to advance
+    @param[in] bus Bus to use
+    @param[in] stream Move all bytes on the chip at once on SPI, set for blocking transfers
+    @return    Number of bytes transferred, 0 if the memory didn't respond
+  */
+  uint32_t address = seekBus(transfer, bus);    // Memory address of the next byte
+  uint32_t offset  = transfer.offset[bus];      // and its position in the transfer
+  if (offset >= transfer.length) return 0;      // No bytes left on this bus
+  uint32_t limit   = transfer.length - offset;  // Bytes left on the bus
+  uint32_t linear  = address;                   // Position in the linear memory space
+  if (_Striped) {
+    linear = _BusStart[bus] + (((address >> MB85_STRIPE_SHIFT) / _BusCount) << MB85_STRIPE_SHIFT) +
+             (address & (MB85_STRIPE_SIZE - 1));  // Address within the stripe
+    uint16_t stripeBytes = MB85_STRIPE_SIZE - (address & (MB85_STRIPE_SIZE - 1));
+    if (limit > stripeBytes) limit = stripeBytes;             // Stay within the stripe
+  }                                                           // of if-then striped
+  uint32_t chipAddress = linear;                              // Address on the memory chip
+  uint32_t endAddress  = 0;                                   // Last address on the memory chip
+  uint8_t  device      = getDevice(chipAddress, endAddress);  // Compute device to use
+  uint32_t chipBytes   = endAddress - chipAddress + 1;        // Bytes left on this chip
+  uint32_t bytes       = chipBytes > limit ? limit : chipBytes;
+  uint32_t run         = MB85_pageBytes(_ChipType[device], chipAddress);  // Bytes on this slave
+  uint8_t *buffer      = transfer.buffer == nullptr ? nullptr : transfer.buffer + offset;
+  uint8_t  bounce[MB85_BOUNCE_SIZE];  // Pattern copies or bytes to compare
+  if (transfer.operation == MB85_PATTERN || transfer.operation == MB85_COMPARE) {
+    if (bytes > MB85_BOUNCE_SIZE) bytes = MB85_BOUNCE_SIZE;
+    if (transfer.operation == MB85_PATTERN) {
+      uint8_t phase = offset % transfer.value;  // Position in the pattern
+      for (uint32_t i = 0; i < bytes; i++) {
+        bounce[i] = transfer.buffer[phase];
+        if (++phase == transfer.value) phase = 0;
+      }  // of for-next each byte
+    }    // of if-then pattern
+    buffer = bounce;
+  }  // of if-then bounce buffer needed
+  MB85_Operation operation = transfer.operation == MB85_PATTERN   ? MB85_WRITE
+                             : transfer.operation == MB85_COMPARE ? MB85_READ
+                                                                  : transfer.operation;
+  bool           resume    = operation == MB85_READ && transfer.latch[bus] == linear &&
+                    _Latched[bus] == &transfer;  // Read continues at the address counter
+  uint8_t        status    = 0;                  // I2C status of the transaction
+  uint32_t       chunk     = 0;                  // Bytes transferred
+  if (_Command != nullptr) {
+    if (!stream && bytes > MB85_SPI_POLL_BYTES) bytes = MB85_SPI_POLL_BYTES;
+    chunk = _Command(*this, device, chipAddress, operation, buffer, transfer.value, bytes);
+    run   = 0;  // Every SPI command sends the memory address
+  } else {
+    chunk = transferI2C(*_Bus[bus], _ChipAddress[device], _ChipType[device], chipAddress,
+                        operation, buffer, transfer.value, bytes, !resume, status, _Retries,
+                        _Stats == nullptr ? nullptr : &_Stats[device]);
+  }  // of if-then-else SPI memory
+  _TransmissionStatus = status;
+  if (transfer.operation == MB85_COMPARE) {
+    for (uint32_t i = 0; i < chunk; i++) {
+      if (bounce[i] != transfer.buffer[offset + i]) {
+        transfer.length = offset + i;  // End the transfer at the first difference
+        break;
+      }  // of if-then bytes differ
+    }    // of for-next each byte
+  }      // of if-then compare
+  if (operation == MB85_READ && chunk < chipBytes && chunk < run) {
+    transfer.latch[bus] = linear + chunk;  // Address counter points at the next byte
+  } else {
+    transfer.latch[bus] = MB85_NO_LATCH;  // Chip, page finished or written, send the address next
+  }                                       // of if-then-else more to read on this chip
+  _Latched[bus] = &transfer;                       // This transfer owns the address counter
+  if (chunk == 0) {                                // Stop if the device didn't respond
+    for (uint8_t b = 0; b < _BusCount; b++) transfer.offset[b] = transfer.length;
+    transfer.failed = true;
+    return 0;
+  }                               // of if-then device didn't respond
+  transfer.offset[bus] += chunk;  // Move on to the next chunk
+  transfer.done += chunk;
+  return chunk;
+}  // of internal method transferChunk()
+uint32_t MB85_FRAM_Class::runTransfer(MB85_Transfer &transfer) {
+  /*!
+    @brief     Perform a complete transfer without returning in between
+    @details   One transaction is performed on each bus in turn, as poll() does
+    @param[in,out] transfer Transfer to perform
+    @return    Number of bytes transferred
+  */
+  while (!finished(transfer)) {
+    for (uint8_t b = 0; b < _BusCount; b++) {
+      if (transfer.offset[b] < transfer.length) transferChunk(transfer, b, true);
+    }  // of for-next each bus
+  }    // of while bytes left to transfer
+  for (uint8_t b = 0; b < _BusCount; b++) {
+    if (_Latched[b] == &transfer) _Latched[b] = nullptr;  // Transfer goes out of scope
+  }                                                       // of for-next each bus
+  return transfer.done;                                   // return the number of bytes transferred
+}  // of internal method runTransfer()
+void MB85_FRAM_Class::countI2C(MB85_Stats &stats, const MB85_Type type,
+                               const MB85_Operation operation, const bool sendAddress,
+                               const uint8_t chunk, const uint8_t status, const bool retry) {
+  /*!
+    @brief     Add one I2C transaction to the counters of a memory
+    @details   The clock cycles are counted as 9 per byte plus one each for START and STOP, a
+               failed transaction only taking the slave address unless the address phase of a read
+               succeeded
+    @param[in,out] stats Counters of the memory
+    @param[in] type Memory type
+    @param[in] operation Read, write or fill
+    @param[in] sendAddress The memory address was sent for a read
+    @param[in] chunk Bytes transferred, 0 if the transaction failed
+    @param[in] status I2C status of the transaction
+    @param[in] retry The transaction is a repeat of a failed one
+  */
+  uint8_t addressBytes = MB85_addressBytes(type);
+  stats.bytes += chunk;
+  stats.retries += retry ? 1 : 0;
+  if (status != 0) stats.naks++;
+  if (operation == MB85_READ && sendAddress && (status == 0 || status == MB85_NO_DATA)) {
+    stats.transactions++;                        // Address phase of the read
+    stats.clocks += 9 * (1 + addressBytes) + 2;  // Slave and memory address
+  }                                              // of if-then address phase sent
+  stats.transactions++;
+  if (status != 0) {
+    stats.clocks += 9 + 2;  // Slave address without acknowledge
+  } else {
+    stats.clocks += 9 * (1 + (operation == MB85_READ ? 0 : addressBytes) + chunk) + 2;
+  }  // of if-then-else failed
+}  // of internal method countI2C()
+uint8_t MB85_FRAM_Class::transferI2C(TwoWire &wire, const uint8_t slave, const MB85_Type type,
+                                     const uint32_t memAddr, const MB85_Operation operation,
+                                     uint8_t *buffer, const uint8_t value, const uint32_t length,
+                                     const bool sendAddress, uint8_t &status,
+                                     const uint8_t retries, MB85_Stats *stats) {
+  /*!
+    @brief     Perform one I2C transaction on a memory, repeating it if it fails
+    @details   This is the transfer core shared by MB85_FRAM_Class and MB85_FRAM_Fixed, so both
+               send the same transactions, repeat them in the same way and count them alike. A
+               failed transaction is repeated up to "retries" times and a repeated read always
+               sends the memory address. See transactI2C() for the transaction itself.
+    @param[in] wire I2C bus of the memory
+    @param[in] slave First I2C address of the memory
+    @param[in] type Memory type
+    @param[in] memAddr Memory address on the device
+    @param[in] operation Read, write or fill
+    @param[in,out] buffer Buffer to read to or write from, unused for a fill
+    @param[in] value Byte value for a fill
+    @param[in] length Number of bytes wanted, limited to the I2C buffer size
+    @param[in] sendAddress Send the memory address for a read
+    @param[out] status I2C status of the last attempt, 0 on success or MB85_NO_DATA if a read
+               returned no bytes
+    @param[in] retries Repeats of a failed transaction, 0 for none
+    @param[in,out] stats Counters of the memory, nullptr if not kept
+    @return    Number of bytes transferred, 0 if the memory didn't respond
+  */
+  uint8_t chunk = 0;  // Bytes transferred
+  for (uint8_t attempt = 0; attempt <= retries && chunk == 0; attempt++) {
+    bool address = sendAddress || attempt > 0;  // A retry sends the memory address again
+    chunk = transactI2C(wire, slave, type, memAddr, operation, buffer, value, length, address,
+                        status);
+    if (stats != nullptr) countI2C(*stats, type, operation, address, chunk, status, attempt > 0);
+  }  // of for-next each attempt
+  return chunk;
+}  // of method transferI2C()
+uint8_t MB85_FRAM_Class::transactI2C(TwoWire &wire, const uint8_t slave, const MB85_Type type,
+                                     const uint32_t memAddr, const MB85_Operation operation,
+                                     uint8_t *buffer, const uint8_t value, const uint32_t length,
+                                     const bool sendAddress, uint8_t &status) {
+  /*!
+    @brief     Perform one I2C transaction on a memory
+    @details   The memory type sets the number of address bytes sent, 1 or 2, and any higher address
+               bits go into the lowest bits of the slave address, so a transaction ends where the
+               slave address changes. A write or fill sends the memory address followed by as many
+               data bytes as fit into the rest of the I2C buffer. A read sends the memory address
+               only when "sendAddress" is set and then reads up to BUFFER_LENGTH bytes, otherwise it
+               continues at the memory's internal address counter. The caller has to make sure that
+               the bytes don't cross the end of the memory.
+    @param[in] wire I2C bus of the memory
+    @param[in] slave First I2C address of the memory
+    @param[in] type Memory type
+    @param[in] memAddr Memory address on the device
+    @param[in] operation Read, write or fill
+    @param[in,out] buffer Buffer to read to or write from, unused for a fill
+    @param[in] value Byte value for a fill
+    @param[in] length Number of bytes wanted, limited to the I2C buffer size
+    @param[in] sendAddress Send the memory address for a read
+    @param[out] status I2C status of the transaction, 0 on success or MB85_NO_DATA if a read
+               returned no bytes
+    @return    Number of bytes transferred, 0 if the memory didn't respond
+  */
+  status                = 0;
+  uint8_t  addressBytes = MB85_addressBytes(type);                // 1 or 2 address bytes
+  uint8_t  device       = slave | memAddr >> (8 * addressBytes);  // Upper bits in slave address
+  uint32_t pageBytes    = MB85_pageBytes(type, memAddr);          // Bytes until the slave changes
+  uint32_t wanted       = length > pageBytes ? pageBytes : length;
+  if (operation == MB85_READ) {
+    uint8_t chunk = wanted > BUFFER_LENGTH ? BUFFER_LENGTH : wanted;
+    if (sendAddress) {
+      wire.beginTransmission(device);                              // Address the I2C device
+      if (addressBytes == 2) wire.write((uint8_t)(memAddr >> 8));  // Send MSB register address
+      wire.write((uint8_t)memAddr);                                // Send LSB address to read
+      status = wire.endTransmission();                             // Close transmission
+      if (status) return 0;                                        // Device didn't acknowledge
+    }                                                              // of if-then send address
+    chunk = wire.requestFrom(device, chunk);                       // Request n-bytes of data
+    if (chunk == 0) status = MB85_NO_DATA;                         // Device didn't respond
+    for (uint8_t i = 0; i < chunk; i++) buffer[i] = wire.read();
+    return chunk;  // Return actual bytes read
+  }                // of if-then read
+  uint8_t room  = BUFFER_LENGTH - addressBytes;  // Data bytes fitting into the I2C buffer
+  uint8_t chunk = wanted > room ? room : wanted;
+  wire.beginTransmission(device);                              // Address the I2C device
+  if (addressBytes == 2) wire.write((uint8_t)(memAddr >> 8));  // Send MSB register address
+  wire.write((uint8_t)memAddr);                                // Send LSB address to write
+  if (operation == MB85_WRITE) {
+    wire.write(buffer, chunk);  // Add the data to the I2C buffer
+  } else {
+    for (uint8_t i = 0; i < chunk; i++) wire.write(value);
+  }                                 // of if-then-else write or fill
+  status = wire.endTransmission();  // Close transmission
+  return status ? 0 : chunk;        // Return bytes written
+}  // of internal method transactI2C()
@@ -9,23 +9,76 @@ described at
 http://www.fujitsu.com/global/products/devices/semiconductor/memory/fram/lineup/index.html and the
 list is detailed below:\n\n
 
+MB85RC1MT    1Mbit (128Kx8bit) ManufacturerID 0x00A, Product ID = 0x758 (Density = 0x7)\n
 MB85RC512T 512Kbit ( 64Kx8bit) ManufacturerID 0x00A, Product ID = 0x658 (Density = 0x6)\n
 MB85RC256V 256Kbit ( 32Kx8bit) ManufacturerID 0x00A, Product ID = 0x510 (Density = 0x5)\n
 MB85RC128A 128Kbit ( 16Kx8bit) No ManufacturerID/productID or Density values\n
 MB85RC64TA  64Kbit (  8Kx8bit) No ManufacturerID/productID or Density values (1.8 to 3.6V)\n
 MB85RC64A   64Kbit (  8Kx8bit) No ManufacturerID/productID or Density values (2.7 to 3.6V)\n
-MB85RC64V   64Kbit (  8Kx8bit) No ManufacturerID/productID or Density values (3.0 to 5.5V)\n\n
-- unsupported memories --\n\n
-MB85RC1MT    1Mbit (128Kx8bit) ManufacturerID 0x00A, Product ID = 0x758 (Density = 0x7)     (unsp)\n
-MB85RC16    16Kbit (  2Kx8bit) No ManufacturerID/productID or Density values  1 Address byte(unsp)\n
-MB85RC16V   16Kbit (  2Kx8bit) No ManufacturerID/productID or Density values  1 Address byte(unsp)\n
-MB85RC04V    4Kbit ( 512x8bit) No ManufacturerID/productID or Density values  1 Address
-byte(unsp)\n\n
-
-There is no direct means of identifying the various chips (apart from the top 3 in the list), so a
-software method is used which makes use of the fact that writing past the end of memory
-automatically wraps back around to the beginning. Thus if we write something 1 byte past the end of
-a chip's address range then byte 0 of the memory will have changed.
+MB85RC64V   64Kbit (  8Kx8bit) No ManufacturerID/productID or Density values (3.0 to 5.5V)\n
+MB85RC16    16Kbit (  2Kx8bit) No ManufacturerID/productID or Density values, 1 Address byte\n
+MB85RC16V   16Kbit (  2Kx8bit) No ManufacturerID/productID or Density values, 1 Address byte\n
+MB85RC04V    4Kbit ( 512x8bit) No ManufacturerID/productID or Density values, 1 Address byte\n\n
+
+The memory address bits which don't fit into the 2 address bytes (MB85RC1MT) or the single address
+byte (MB85RC04V and MB85RC16) are sent in the lowest bits of the I2C slave address, so these
+memories take up 2 (MB85RC1MT and MB85RC04V) or all 8 (MB85RC16) of the slave addresses. A transfer
+is split where the slave address changes.\n\n
+
+ @subsection detection_section Memory detection
+
+begin() identifies the memories with a ManufacturerID by the Fujitsu Device ID command. The others
+are found by writing one byte past the end of the assumed memory size and checking whether byte 0
+changed, as the address wraps around. Memories with 1 address byte are checked first with a 1 byte
+address. When the memories are known in advance they can be passed to begin() as a layout, which
+doesn't access the I2C bus at all. The MB85_FRAM_Fixed template in "MB85_FRAM_Fixed.h" takes the
+memory types as template parameters and turns the address lookups into compile-time constants.\n\n
+
+ @subsection buses_section Several I2C buses
+
+Memories can be attached to up to MB85_FRAM_BUSES I2C buses by passing the buses to the
+constructor. The memory of all buses is either used one bus after the other (MB85_CONTIGUOUS) or
+striped across the buses in 256 byte blocks (MB85_STRIPED).\n\n
+
+ @subsection spi_section SPI memories
+
+MB85_FRAM_SPI_Class in "MB85_FRAM_SPI.h" uses the MB85RS memories through the same functions. It
+takes the SPI bus and the chip select pins in its constructor. Only sketches which include that
+header need the SPI library.\n\n
+
+ @subsection async_section Asynchronous transfers
+
+readAsync(), writeAsync() and fillAsync() queue a transfer, which is then performed by repeated
+calls to poll() with at most one I2C transaction per call. The queue is an array of MB85_Transfer
+given to attachQueue().\n\n
+
+ @subsection bulk_section Fill, copy and compare
+
+fill() writes a byte value or a repeating pattern, copy() moves a range with memmove() semantics
+and compare() checks a range against a buffer. They send full-length transfers across memory
+boundaries. compare() returns MB85_COMPARE_FAILED if a memory didn't respond.\n\n
+
+ @subsection errors_section Errors and counters
+
+All transfer methods return the number of bytes actually transferred. A failed I2C transaction is
+repeated up to MB85_RETRIES times, see setRetries(), and status() returns the Wire status of the
+last transaction. attachStats() counts the transactions, bytes, failures, retries and bus clock
+cycles of each memory, busMicros() converts them to bus time.\n\n
+
+ @subsection options_section Build options
+
+MB85_FRAM_BUSES sets the number of I2C buses and MB85_FRAM_GRANULES the size of the table used to
+find the memory of an address, 0 to search the memories instead. Both default to the smallest
+setting on AVR and have to be set as compiler flags for the whole build.\n\n
+
+ @subsection helpers_section Helper classes
+
+- MB85_FRAM_Cache ("MB85_FRAM_Cache.h"): write-back cache for small scattered accesses\n
+- MB85_FRAM_RingLog ("MB85_FRAM_RingLog.h"): power-fail safe log of variable-length records\n
+- MB85_FRAM_KVStore ("MB85_FRAM_KVStore.h"): records with a 32 bit key in hashed buckets\n
+- MB85_FRAM_Stream ("MB85_FRAM_Stream.h"): Arduino Stream over a region of the memory\n
+- MB85_FRAM_Array ("MB85_FRAM_Array.h"): indexed array of any data type\n
+- MB85_FRAM_Batch ("MB85_FRAM_Batch.h"): sorted and merged scattered reads and writes\n
 
  @section doxygen doxygen configuration
 
@@ -61,6 +114,21 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 Version| Date       | Developer  | Comments
 ------ | ---------- | ---------- | --------
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_Batch scatter/gather queue with merged transfers
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_Stream and MB85_FRAM_Array buffered access
+1.1.0  | 2026-10-16 | SV-Zanshin | Per-memory counters, I2C retries and the last status in status()
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_KVStore hash-indexed key value store
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_RingLog power-fail safe ring log
+1.1.0  | 2026-10-16 | SV-Zanshin | Added fill(), copy() and compare(), fillMemory() uses fill()
+1.1.0  | 2026-10-16 | SV-Zanshin | SPI MB85RS memories with the same API as the I2C memories
+1.1.0  | 2026-10-16 | SV-Zanshin | Support for MB85RC1MT, MB85RC16 and MB85RC04V memories
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_Fixed compile-time layout in MB85_FRAM_Fixed.h
+1.1.0  | 2026-10-16 | SV-Zanshin | Memories on several I2C buses, contiguous or striped
+1.1.0  | 2026-10-16 | SV-Zanshin | Asynchronous transfers with readAsync(), writeAsync() and poll()
+1.1.0  | 2026-10-16 | SV-Zanshin | Added MB85_FRAM_Cache write-back cache in MB85_FRAM_Cache.h
+1.1.0  | 2026-10-16 | SV-Zanshin | Device ID detection and begin() with a known memory layout
+1.1.0  | 2026-10-16 | SV-Zanshin | Constant-time address to device translation table
+1.1.0  | 2026-10-16 | SV-Zanshin | Added readBlock() and writeBlock() with 32-bit lengths
 1.0.6  | 2022-10-02 | LMFLox     | Issue #7 - corrected computation of chip type
 1.0.5  | 2019-01-26 | SV-Zanshin | Issue #4 - converted documentation to doxygen
 1.0.4  | 2018-07-22 | SV-Zanshin | Corrected I2C Datatypes
@@ -95,8 +163,135 @@ const uint32_t I2C_FAST_MODE{400000};             ///< Fast mode
 const uint32_t I2C_FAST_MODE_PLUS_MODE{1000000};  ///< Really fast mode
 const uint32_t I2C_HIGH_SPEED_MODE = {3400000};   ///< Turbo mode
   #endif
-const uint8_t MB85_MIN_ADDRESS{0x50};  ///< Minimum FRAM address
-const uint8_t MB85_MAX_DEVICES{8};     ///< Maximum number of FRAM devices
+const uint8_t  MB85_MIN_ADDRESS{0x50};             ///< Minimum FRAM address
+const uint8_t  MB85_MAX_DEVICES{8};                ///< Maximum number of FRAM devices
+const uint8_t  MB85_DEVICE_ID_ADDRESS{0xF8 >> 1};  ///< Reserved slave address for the Device ID
+const uint16_t MB85_MANUFACTURER_ID{0x00A};        ///< Fujitsu manufacturer ID
+const uint8_t  MB85_MIN_DENSITY{0x5};              ///< Smallest Device ID density (32kB)
+const uint8_t  MB85_MAX_DENSITY{0x7};              ///< Largest supported density (128kB)
+const uint8_t  MB85_ASYNC_QUEUE{4};                ///< Suggested entries of an attachQueue() array
+const uint8_t  MB85_STRIPE_SHIFT{8};               ///< log2 of the stripe size for striped buses
+const uint16_t MB85_STRIPE_SIZE{256};              ///< Stripe size, 2 to the MB85_STRIPE_SHIFT
+const uint32_t MB85_NO_LATCH{0xFFFFFFFF};          ///< Address counter position is unknown
+const uint8_t  MB85_SPI_POLL_BYTES{32};            ///< Bytes per SPI transaction in poll()
+const uint8_t  MB85_RETRIES{2};                    ///< Default repeats of a failed I2C transaction
+const uint8_t  MB85_NO_DATA{6};                    ///< Status of a read which returned no data
+const uint32_t MB85_COMPARE_FAILED{0xFFFFFFFF};    ///< compare() result if a memory didn't respond
+  /*************************************************************************************************
+  ** Configuration of the table sizes. These change the class layout, so they have to be set      **
+  ** for the whole build as compiler flags, e.g. "-DMB85_FRAM_BUSES=2", not in a sketch           **
+  *************************************************************************************************/
+  #ifndef MB85_FRAM_BUSES
+    #if defined(__AVR__)
+      /** @brief  Maximum number of I2C buses, 1 on AVR to save RAM */
+      #define MB85_FRAM_BUSES 1
+    #else
+      /** @brief  Maximum number of I2C buses */
+      #define MB85_FRAM_BUSES 4
+    #endif
+  #endif
+  #ifndef MB85_FRAM_GRANULES
+    #if defined(__AVR__)
+      /** @brief  Entries in the address-to-device table, 0 on AVR to search the memories instead */
+      #define MB85_FRAM_GRANULES 0
+    #else
+      /** @brief  Entries in the address-to-device table, 0 to search the memories instead */
+      #define MB85_FRAM_GRANULES 64
+    #endif
+  #endif
+const uint8_t MB85_MAX_BUSES{MB85_FRAM_BUSES};                    ///< Maximum number of I2C buses
+const uint8_t MB85_GRANULES{MB85_FRAM_GRANULES};                  ///< Address-to-device entries
+const uint8_t MB85_MAX_CHIPS{MB85_MAX_DEVICES * MB85_MAX_BUSES};  ///< Memories on all buses
+/*! @brief  Bytes in the stack buffer of copy(), compare() and pattern fills, two I2C writes */
+const uint16_t MB85_BOUNCE_SIZE{2 * (BUFFER_LENGTH - 2)};
+
+/*! @brief  Memory types for begin() with a known layout, the value is log2 of the memory size */
+enum MB85_Type : uint8_t {
+  MB85_NONE  = 0,   ///< No memory at this address
+  MB85RC04V  = 9,   ///< MB85RC04V with 512 bytes and 1 address byte, uses 2 slave addresses
+  MB85RC16   = 11,  ///< MB85RC16 or MB85RC16V with 2kB and 1 address byte, uses 8 slave addresses
+  MB85RC64   = 13,  ///< MB85RC64TA, MB85RC64A or MB85RC64V with 8kB
+  MB85RC128A = 14,  ///< MB85RC128A with 16kB
+  MB85RC256V = 15,  ///< MB85RC256V with 32kB
+  MB85RC512T = 16,  ///< MB85RC512T with 64kB
+  MB85RC1MT  = 17,  ///< MB85RC1MT with 128kB, uses 2 slave addresses
+  MB85RS64V  = 13,  ///< SPI MB85RS64V or MB85RS64T with 8kB
+  MB85RS128B = 14,  ///< SPI MB85RS128B with 16kB
+  MB85RS256B = 15,  ///< SPI MB85RS256B with 32kB
+  MB85RS512T = 16,  ///< SPI MB85RS512T with 64kB
+  MB85RS1MT  = 17,  ///< SPI MB85RS1MT with 128kB and 3 address bytes
+  MB85RS2MT  = 18,  ///< SPI MB85RS2MT with 256kB and 3 address bytes
+  MB85RS4MT  = 19   ///< SPI MB85RS4MT with 512kB and 3 address bytes
+};
+
+/*! @brief  Return the size of a memory type in bytes */
+constexpr uint32_t MB85_typeBytes(const MB85_Type type) { return type ? 1UL << type : 0; }
+/*! @brief  Return the number of memory address bytes sent to a memory type */
+constexpr uint8_t MB85_addressBytes(const MB85_Type type) { return type <= MB85RC16 ? 1 : 2; }
+/*! @brief  Return the number of I2C slave addresses used by a memory type */
+constexpr uint8_t MB85_slaveCount(const MB85_Type type) {
+  return type > 8 * MB85_addressBytes(type) ? 1 << (type - 8 * MB85_addressBytes(type)) : 1;
+}
+/*! @brief  Return the number of bytes from a memory address to the next change of slave address */
+constexpr uint32_t MB85_pageBytes(const MB85_Type type, const uint32_t memAddr) {
+  return (1UL << (8 * MB85_addressBytes(type))) -
+         (memAddr & ((1UL << (8 * MB85_addressBytes(type))) - 1));
+}
+/*! @brief  Return the CRC-16/CCITT of a block of bytes, used by the structures built on top */
+uint16_t MB85_crc16(const uint8_t *data, const uint32_t length, uint16_t crc = 0xFFFF);
+
+/*! @brief  How the memory on several I2C buses is combined into one address space */
+enum MB85_Mapping : uint8_t {
+  MB85_CONTIGUOUS = 0,  ///< The memory of each bus follows that of the previous bus
+  MB85_STRIPED    = 1   ///< Consecutive 256 byte stripes are spread across the buses in turn
+};
+
+/*! @brief  Kind of transfer performed by the transfer engine */
+enum MB85_Operation : uint8_t {
+  MB85_READ    = 0,  ///< Read bytes into the buffer
+  MB85_WRITE   = 1,  ///< Write bytes from the buffer
+  MB85_FILL    = 2,  ///< Write the same byte value repeatedly, no buffer is used
+  MB85_PATTERN = 3,  ///< Write a pattern from the buffer repeatedly, "value" is its length
+  MB85_COMPARE = 4   ///< Compare with the buffer, the length is cut at the first difference
+};
+
+/*! @brief  Completion callback for asynchronous transfers, called with the transfer's buffer
+            (nullptr for a fill) and the number of bytes actually transferred */
+typedef void (*MB85_Callback)(uint8_t *buffer, const uint32_t bytes);
+
+class MB85_FRAM_Class;
+/*! @brief  Command on a memory which isn't on an I2C bus, called by the transfer engine with the
+            memory number, the address on the memory and the bytes to move, see MB85_FRAM_SPI.h */
+typedef uint32_t (*MB85_Command)(MB85_FRAM_Class &fram, const uint8_t device,
+                                 const uint32_t memAddr, const MB85_Operation operation,
+                                 uint8_t *buffer, const uint8_t value, const uint32_t length);
+
+/*! @brief  State of one transfer, advanced one I2C transaction per bus at a time by the transfer
+            engine. The bytes on each bus are handled independently, so that all buses can be
+            busy with the same transfer. */
+struct MB85_Transfer {
+  uint32_t       address;                  ///< First memory address
+  uint8_t       *buffer;                   ///< Buffer to read to or write from, nullptr for a fill
+  uint32_t       length;                   ///< Bytes to transfer
+  uint32_t       done;                     ///< Bytes transferred so far
+  uint32_t       offset[MB85_MAX_BUSES];   ///< Next byte to transfer on each bus
+  uint32_t       latch[MB85_MAX_BUSES];    ///< Address counter of the memory used on each bus
+  MB85_Callback  callback;                 ///< Called on completion, may be nullptr
+  MB85_Operation operation;                ///< Read, write, fill, pattern fill or compare
+  uint8_t        value;                    ///< Byte value for a fill, pattern length for a pattern
+  bool           failed;                   ///< Set when a memory didn't respond
+};
+
+/*! @brief  Bus usage counters of one memory, kept by MB85_FRAM_Class once attachStats() is called.
+            The clock cycles are counted as 9 per I2C byte plus START and STOP, or 8 per SPI
+            byte, so busMicros() gives the bus time without the gaps between transactions. */
+struct MB85_Stats {
+  uint32_t transactions;  ///< I2C transactions or SPI chip select windows
+  uint32_t bytes;         ///< Data bytes transferred
+  uint32_t naks;          ///< I2C transactions which failed, either not acknowledged or no data
+  uint32_t retries;       ///< I2C transactions repeated after a failure
+  uint64_t clocks;        ///< SCL or SCK clock cycles used
+};
 
 /*************************************************************************************************
 ** Main MB85_FRAM class for the SRAM memory                                                     **
@@ -107,135 +302,157 @@ class MB85_FRAM_Class {
    * @brief   Access the MB85_FRAM Family of memories
    */
  public:
-  MB85_FRAM_Class();
+  MB85_FRAM_Class(TwoWire &bus = Wire);
+  MB85_FRAM_Class(TwoWire &bus0, TwoWire &bus1);
+  MB85_FRAM_Class(TwoWire *const buses[], const uint8_t busCount);
   ~MB85_FRAM_Class();
-  uint8_t  begin(const uint32_t i2cSpeed = I2C_STANDARD_MODE);
+  uint8_t  begin(const uint32_t     i2cSpeed = I2C_STANDARD_MODE,
+                 const MB85_Mapping mapping  = MB85_CONTIGUOUS);
+  uint8_t  begin(const MB85_Type    layout[MB85_MAX_DEVICES],
+                 const uint32_t     i2cSpeed = I2C_STANDARD_MODE,
+                 const MB85_Mapping mapping  = MB85_CONTIGUOUS);
   uint32_t totalBytes();
   uint32_t memSize(const uint8_t memNumber);
+  uint32_t readBlock(const uint32_t addr, uint8_t *buffer, const uint32_t length);
+  uint32_t writeBlock(const uint32_t addr, const uint8_t *buffer, const uint32_t length);
+  uint32_t fill(const uint32_t addr, const uint32_t length, const uint8_t value);
+  uint32_t fill(const uint32_t addr, const uint32_t length, const uint8_t *pattern,
+                const uint8_t patternLength);
+  uint32_t copy(const uint32_t source, const uint32_t destination, const uint32_t length);
+  uint32_t compare(const uint32_t addr, const uint8_t *buffer, const uint32_t length);
+  bool     readAsync(const uint32_t addr, uint8_t *buffer, const uint32_t length,
+                     MB85_Callback callback = nullptr);
+  bool     writeAsync(const uint32_t addr, const uint8_t *buffer, const uint32_t length,
+                      MB85_Callback callback = nullptr);
+  bool     fillAsync(const uint32_t addr, const uint32_t length, const uint8_t value,
+                     MB85_Callback callback = nullptr);
+  void     attachQueue(MB85_Transfer queue[], const uint8_t size);
+  bool     poll();
+  uint8_t  pending();
+  uint8_t  status();
+  void     setRetries(const uint8_t retries);
+  void     attachStats(MB85_Stats stats[]);
+  uint32_t busMicros(const uint8_t memNumber);
+  static uint8_t transferI2C(TwoWire &wire, const uint8_t slave, const MB85_Type type,
+                             const uint32_t memAddr, const MB85_Operation operation,
+                             uint8_t *buffer, const uint8_t value, const uint32_t length,
+                             const bool sendAddress, uint8_t &status,
+                             const uint8_t retries = 0, MB85_Stats *stats = nullptr);
   /*!
     @brief     Declare the read method as a template function
     @details   Declare the read method as a template function, this needs to be done in the header
                file rather than by declaring the prototype here and putting the body into the cpp
-               library file. All reading is done through this function. Multiple memories are
-               treated as if they were one large memory, the space is contiguous and a read will
-               wrap around from the end of memory to the beginning. The function can be called with
-               any type of argument as the "&value", including arrays and structures. Although the
-               I2C "wire" has a 32 byte buffer limit, this library will automatically split bigger
-               reads into multiple calls. The size of the "&value" parameter is returned as the
-               optional function value
+               library file. The function can be called with any type of argument as the "&value",
+               including arrays and structures of any size, and the actual reading is done by
+               readBlock(). Multiple memories are treated as if they were one large memory, the
+               space is contiguous and a read will wrap around from the end of memory to the
+               beginning.
     @param[in] addr Memory address
     @param[in] value Data Type "T" to read
     @return    Number of bytes read
   */
   template <typename T>
-  uint8_t &read(const uint32_t addr, T &value) {
-    uint8_t *      bytePtr    = (uint8_t *)&value;                  // Ptr to structure beginning
-    static uint8_t structSize = sizeof(T);                          // Number of bytes in struct
-    uint32_t       memAddress = addr % _TotalMemory;                // No value greater than max
-    uint32_t       endAddress = 0;                                  // Last addr on current memo
-    uint8_t        device     = getDevice(memAddress, endAddress);  // Compute device to use
-    for (uint8_t i = 0; i < structSize; i++) {
-      if (i % (BUFFER_LENGTH - 2) == 0) {
-        requestI2C(device, memAddress, structSize, true);  // If buffer full, then get data from mem
-      }                                                    // if our read buffer is full
-      *bytePtr++ = Wire.read();                            // Put byte read to pointer address
-      if (memAddress++ == endAddress)                      // If we've reached the end-of-chip
-      {
-        for (uint8_t j = 0; j < MB85_MAX_DEVICES; j++)  // loop to get the next device
-        {
-          if (device++ == MB85_MAX_DEVICES) {
-            device = 0;
-          }                  // of if-then we've reached the end of device list
-          if (_I2C[device])  // On a match, address device
-          {
-            requestI2C(device, 0, structSize, true);  // Get bytes from new memory chip
-            memAddress = 0;                           // New memory address
-            break;                                    // And stop looking for a new memory
-          }                                           // of if we've got the next memory
-        }                                             // of for-next loop through each device
-      }                   // of if-then we've reached the end of the physical memory
-    }                     // of loop for each byte
-    return (structSize);  // return the number of bytes read
-  }                       // of method read()
+  uint32_t read(const uint32_t addr, T &value) {
+    return readBlock(addr, (uint8_t *)&value, sizeof(T));  // Read the bytes of the value
+  }                                                         // of method read()
 
   template <typename T>
-  uint8_t &write(const uint32_t addr, const T &value) {
+  uint32_t write(const uint32_t addr, const T &value) {
     /*!
       @brief     Declare the write method as a template function
-     @details    Declare the write method as a template function, this needs to be done in the
+      @details   Declare the write method as a template function, this needs to be done in the
                  header file rather than by declaring the prototype here and putting the body
-                 into the cpp library file. All reading is done through this function. Multiple
-                 memories are treated as if they were one large memory, the space is contiguous
-                 and a read will wrap around from the end of memory to the beginning. The
-                 function can be called with any type of argument as the "&value", including
-                 arrays and structures. Although the I2C "wire" has a 32 byte buffer limit, this
-                 library will automatically split bigger reads into multiple calls. The size of
-                 the "&value" parameter is returned as the optional function value
-    * @param[in] addr Memory address
-    * @param[in] value Data Type "T" to write
-    * @return    Number of bytes written
+                 into the cpp library file. The function can be called with any type of argument
+                 as the "&value", including arrays and structures of any size, and the actual
+                 writing is done by writeBlock(). Multiple memories are treated as if they were
+                 one large memory, the space is contiguous and a write will wrap around from the
+                 end of memory to the beginning.
+      @param[in] addr Memory address
+      @param[in] value Data Type "T" to write
+      @return    Number of bytes written
     */
-    const uint8_t *bytePtr    = (const uint8_t *)&value;        // Pointer to structure beginning
-    static uint8_t structSize = sizeof(T);                      // Number of bytes in structure
-    uint32_t       memAddress = addr % _TotalMemory;            // Ensure no value greater than max
-    uint32_t       endAddress = 0;                              // Last address on current memory
-    uint8_t        device = getDevice(memAddress, endAddress);  // Compute the actual device to use
-    for (uint8_t i = 0; i < structSize; i++) {
-      if (i % (BUFFER_LENGTH - 2) == 0) {
-        if (i > 0) {
-          _TransmissionStatus = Wire.endTransmission();     // Close active xmission
-        }                                                   // of if-then end of buffer reached
-        requestI2C(device, memAddress, structSize, false);  // Position for next buffer data
-      }                                                     // if our write buffer is full
-      Wire.write(*bytePtr++);                               // Write current byte to memory
-      if (memAddress++ == endAddress) {
-        _TransmissionStatus = Wire.endTransmission();   // Close transmission
-        for (uint8_t j = 0; j < MB85_MAX_DEVICES; j++)  // loop to get the next device
-        {
-          if (device++ == MB85_MAX_DEVICES)  // If at last device then restart
-          {
-            device = 0;
-          }                  // of if-then reached end of devices
-          if (_I2C[device])  // If at last device then restart
-          {
-            requestI2C(device, 0, structSize, false);  // Position memory pointer to begin
-            memAddress = 0;                            // New memory address
-            break;                                     // And stop looking for a new memory
-          }                                            // of if we've got the next memory
-        }                                              // of for-next loop through each device
-      }  // of if-then we've reached the end of the physical memory
-    }    // of for each byte to write
-    _TransmissionStatus = Wire.endTransmission();  // Close transmission
-    return (structSize);                           // return number of bytes written
-  }                                                // of method write()
+    return writeBlock(addr, (const uint8_t *)&value, sizeof(T));  // Write the bytes of the value
+  }                                                                // of method write()
 
   template <typename T>
-  uint32_t &fillMemory(const T &value) {
+  uint32_t fillMemory(const T &value) {
     /*!
        @brief     Declare the fillMemory() method to write as many copies of the "&value"
                   parameter as will fit into the the available memory space
-       @details   The bigger the "&value" datatype is, the faster this call will function. Any
-                  extra bytes left over if the memory is not divisible by the length of the
-                  "&data" is left
-       untouched
+       @details   The copies are written by fill() as one pattern in as few transactions as
+                  possible, so the size of the "&value" datatype doesn't matter. Any extra bytes
+                  left over if the memory is not divisible by the length of the "&value" are left
+                  untouched.
        @param[in] value Data Type "T" to fill memory with
-       @return    Number of loop iterations used to fill memory
+       @return    Number of copies written
      */
-    uint8_t  structSize = sizeof(T);  // Number of bytes in structure
-    uint32_t i;
-    for (i = 0; i < (_TotalMemory / structSize); i++) {
-      write(i * structSize, value);  // Write structure to memory
-    }                                // of for-next loop on structure size
-    return i;                        // return the number of copies written
-  }                                  // of method fillMemory()
+    uint32_t copies = _TotalMemory / sizeof(T);  // Number of whole copies fitting into memory
+    if (sizeof(T) > UINT8_MAX) {                 // Too long for a pattern, but long enough to
+      for (uint32_t i = 0; i < copies; i++) {    // write efficiently one copy at a time
+        if (write(i * sizeof(T), value) != sizeof(T)) return i;
+      }  // of for-next each copy
+      return copies;
+    }  // of if-then large structure
+    return fill(0, copies * sizeof(T), (const uint8_t *)&value, sizeof(T)) / sizeof(T);
+  }  // of method fillMemory()
 
  private:
+  void     startBuses(const uint32_t i2cSpeed);
+  uint32_t readDeviceID(TwoWire &bus, const uint8_t address);
+  uint32_t probeSize(TwoWire &bus, const uint8_t address);
+  uint32_t probeShortAddress(TwoWire &bus, const uint8_t slot, const uint8_t found);
+  uint8_t  readByte(TwoWire &bus, const uint8_t address, const uint16_t memAddr);
+  void     writeByte(TwoWire &bus, const uint8_t address, const uint16_t memAddr,
+                     const uint8_t value);
   uint8_t  getDevice(uint32_t &memAddress, uint32_t &endAddress);
-  int8_t   requestI2C(const uint8_t device, const uint32_t memAddress, const uint16_t dataSize,
-                      const bool endTrans);
-  uint8_t  _DeviceCount           = 0;      ///< Number of memories found
-  uint32_t _TotalMemory           = 0;      ///< Number of bytes in total
-  uint8_t  _I2C[MB85_MAX_DEVICES] = {0};    ///< List of device kB capacities
-  bool     _TransmissionStatus    = false;  ///< I2C communications status
-};                                          // of MB85_FRAM class definition
+  uint32_t seekBus(MB85_Transfer &transfer, const uint8_t bus);
+  bool     finished(MB85_Transfer &transfer);
+  void     setTransfer(MB85_Transfer &transfer, const MB85_Operation operation, const uint32_t addr,
+                       uint8_t *buffer, const uint32_t length, const uint8_t value,
+                       MB85_Callback callback);
+  bool     queueTransfer(const MB85_Operation operation, const uint32_t addr, uint8_t *buffer,
+                         const uint32_t length, const uint8_t value, MB85_Callback callback);
+  uint32_t transferChunk(MB85_Transfer &transfer, const uint8_t bus, const bool stream);
+  uint32_t runTransfer(MB85_Transfer &transfer);
+  static uint8_t transactI2C(TwoWire &wire, const uint8_t slave, const MB85_Type type,
+                             const uint32_t memAddr, const MB85_Operation operation,
+                             uint8_t *buffer, const uint8_t value, const uint32_t length,
+                             const bool sendAddress, uint8_t &status);
+  static void    countI2C(MB85_Stats &stats, const MB85_Type type, const MB85_Operation operation,
+                          const bool sendAddress, const uint8_t chunk, const uint8_t status,
+                          const bool retry);
+
+ protected:
+  void buildTable(const MB85_Type types[], const MB85_Mapping mapping,
+                  const uint8_t pins[] = nullptr, const uint8_t pinCount = 0);
+
+  uint8_t   _DeviceCount                   = 0;      ///< Number of memories found
+  uint32_t  _TotalMemory                   = 0;      ///< Number of bytes in total
+  MB85_Type _ChipType[MB85_MAX_CHIPS]      = {};     ///< Type of each memory in order
+  uint8_t   _ChipAddress[MB85_MAX_CHIPS]   = {0};    ///< I2C address or SPI chip select pin
+  uint8_t   _ChipBus[MB85_MAX_CHIPS]       = {0};    ///< I2C bus of each memory in order
+  uint32_t  _ChipStart[MB85_MAX_CHIPS + 1] = {0};    ///< Start of each memory, then total
+  uint32_t  _BusStart[MB85_MAX_BUSES + 1]  = {0};    ///< Start of each bus's memories, then total
+  #if MB85_FRAM_GRANULES > 0
+  uint8_t _Granule[MB85_GRANULES] = {0};  ///< First memory in each granule
+  uint8_t _GranuleShift           = 0;    ///< log2 of granule size in bytes
+  #endif
+  uint8_t   _ChipShift                     = 0;      ///< log2 of memory size if all are equal
+  uint8_t   _BusCount                      = 0;      ///< Number of I2C buses
+  bool      _Striped                       = false;  ///< Memory is striped across the buses
+  uint8_t   _TransmissionStatus            = 0;      ///< Wire status of the last transaction
+
+  TwoWire       *_Bus[MB85_MAX_BUSES];                ///< I2C buses used
+  MB85_Transfer *_Queue                   = nullptr;  ///< Asynchronous queue, nullptr if none
+  uint8_t        _QueueSize               = 0;        ///< Entries in the queue
+  uint8_t        _QueueHead               = 0;        ///< Index of the oldest queued transfer
+  uint8_t        _QueueCount              = 0;        ///< Number of queued transfers
+  MB85_Transfer *_Latched[MB85_MAX_BUSES] = {0};      ///< Transfer that last used each bus
+
+  uint8_t     _Retries = MB85_RETRIES;  ///< Repeats of a failed I2C transaction
+  MB85_Stats *_Stats   = nullptr;       ///< Counters of each memory, nullptr if not kept
+  uint32_t    _Clock   = 0;             ///< I2C or SPI clock in Hz
+
+  MB85_Command _Command = nullptr;  ///< Command of memories off the I2C bus, nullptr for I2C
+};                                  // of MB85_FRAM class definition
 #endif
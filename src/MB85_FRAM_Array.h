@@ -0,0 +1,107 @@
+/*! @file MB85_FRAM_Array.h
+ @section MB85_FRAM_Array_intro_section Description
+
+ Indexed view of an array of any data type in a region of the memory of an MB85_FRAM_Class
+ instance. The elements are read and written through an MB85_FRAM_Stream, so walking through the
+ array in index order fetches BUFFER_LENGTH bytes per read and combines the writes of consecutive
+ elements into full I2C transmissions, instead of paying an address phase for every element as a
+ loop of read() and write() calls does. Elements are accessed with get() and set() or with the []
+ operator, which returns a proxy so that "array[i] = array[i] + 1" reads and writes the memory.
+ Pending writes are written out by flush() or when the array goes out of scope. See main library
+ header file for details
+*/
+#ifndef MB85_FRAM_ARRAY
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_ARRAY
+  #include "MB85_FRAM_Stream.h"  // Include the buffered stream
+
+template <typename T>
+class MB85_FRAM_Array {
+  /*!
+   * @class   MB85_FRAM_Array
+   * @brief   Buffered indexed access to an array of "T" in FRAM
+   * @tparam  T Element data type, any type which can be copied byte by byte
+   */
+ public:
+  class Element {
+    /*!
+     * @class   Element
+     * @brief   Proxy for one array element returned by the [] operator
+     */
+   public:
+    Element(MB85_FRAM_Array &array, const uint32_t index) : _Array(array), _Index(index) {}
+    operator T() const { return _Array.get(_Index); }  ///< Read the element
+    Element &operator=(const T &value) {
+      /*!
+        @brief     Write the element
+        @param[in] value Value to write
+        @return    The element
+      */
+      _Array.set(_Index, value);
+      return *this;
+    }  // of method operator=()
+    Element &operator=(const Element &other) {
+      /*!
+        @brief     Copy another element into this one
+        @param[in] other Element to copy
+        @return    The element
+      */
+      _Array.set(_Index, (T)other);
+      return *this;
+    }  // of method operator=()
+
+   private:
+    MB85_FRAM_Array &_Array;  ///< Array holding the element
+    uint32_t         _Index;  ///< Element index
+  };                          // of class Element
+
+  MB85_FRAM_Array(MB85_FRAM_Class &fram, const uint32_t start, const uint32_t count)
+      : _Stream(fram, start, count * sizeof(T)), _Count(count) {
+    /*!
+     * @brief     Class constructor
+     * @param[in] fram Memory holding the array, begin() needs to have been called before the
+     *            first access
+     * @param[in] start Memory address of the first element
+     * @param[in] count Number of elements
+     */
+  }  // of class constructor
+  T get(const uint32_t index) {
+    /*!
+      @brief     Read an element
+      @param[in] index Element index
+      @return    Element value, all bytes 0 if the index is out of range
+    */
+    T value;
+    memset((void *)&value, 0, sizeof(T));
+    if (index < _Count && _Stream.seek(index * sizeof(T))) {
+      _Stream.read((uint8_t *)&value, sizeof(T));
+    }  // of if-then index in range
+    return value;
+  }  // of method get()
+  bool set(const uint32_t index, const T &value) {
+    /*!
+      @brief     Write an element
+      @param[in] index Element index
+      @param[in] value Element value
+      @return    true if the element was written or is pending, false if the index is out of range
+    */
+    return index < _Count && _Stream.seek(index * sizeof(T)) &&
+           _Stream.write((const uint8_t *)&value, sizeof(T)) == sizeof(T);
+  }  // of method set()
+  Element operator[](const uint32_t index) {
+    /*!
+      @brief     Return a proxy for an element, which reads on conversion to "T" and writes when
+                 assigned to
+      @param[in] index Element index
+      @return    Element proxy
+    */
+    return Element(*this, index);
+  }  // of method operator[]()
+  uint32_t size() const { return _Count; }  ///< Return the number of elements
+  void     flush() { _Stream.flush(); }     ///< Write out pending element writes
+
+ private:
+  MB85_FRAM_Stream _Stream;  ///< Buffered access to the region
+  uint32_t         _Count;   ///< Number of elements
+};                           // of class MB85_FRAM_Array
+#endif
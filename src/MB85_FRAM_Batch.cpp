@@ -0,0 +1,153 @@
+/*! @file MB85_FRAM_Batch.cpp
+ @section MB85_FRAM_Batch_cpp_intro_section Description
+
+ Implementation of the MB85_FRAM_Batch class, see MB85_FRAM_Batch.h for details
+*/
+#include "MB85_FRAM_Batch.h"  // Include the header definition
+
+MB85_FRAM_Batch::MB85_FRAM_Batch(MB85_FRAM_Class &fram) : _FRAM(fram) {
+  /*!
+   * @brief     Class constructor
+   * @param[in] fram Memory accessed, begin() needs to have been called before execute()
+   */
+}  // of class constructor
+bool MB85_FRAM_Batch::queueRead(const uint32_t addr, uint8_t *buffer, const uint16_t length) {
+  /*!
+   * @brief     Queue a read
+   * @param[in] addr Memory address
+   * @param[in] buffer Buffer to read to, needs to stay valid until execute()
+   * @param[in] length Number of bytes
+   * @return    true if the read was queued, false if the queue is full or the length is 0
+   */
+  return queue(MB85_READ, addr, buffer, length);
+}  // of method queueRead()
+bool MB85_FRAM_Batch::queueWrite(const uint32_t addr, const uint8_t *buffer,
+                                 const uint16_t length) {
+  /*!
+   * @brief     Queue a write
+   * @param[in] addr Memory address
+   * @param[in] buffer Bytes to write, read by execute() and need to stay valid until then
+   * @param[in] length Number of bytes
+   * @return    true if the write was queued, false if the queue is full or the length is 0
+   */
+  return queue(MB85_WRITE, addr, (uint8_t *)buffer, length);
+}  // of method queueWrite()
+uint8_t MB85_FRAM_Batch::execute() {
+  /*!
+   * @brief     Transfer all queued entries, first the reads and then the writes
+   * @details   The entries stay queued, so that calling execute() again repeats the transfers
+   * @return    Number of entries whose bytes were all transferred
+   */
+  if (!_Sorted) sort();
+  uint8_t done = transfer(MB85_READ);
+  return done + transfer(MB85_WRITE);
+}  // of method execute()
+uint8_t MB85_FRAM_Batch::queued() const {
+  /*!
+   * @brief     Return the number of queued entries
+   * @return    Number of entries
+   */
+  return _Count;
+}  // of method queued()
+void MB85_FRAM_Batch::clear() {
+  /*!
+   * @brief     Remove all queued entries
+   */
+  _Count  = 0;
+  _Sorted = true;
+}  // of method clear()
+bool MB85_FRAM_Batch::queue(const MB85_Operation operation, const uint32_t addr, uint8_t *buffer,
+                            const uint16_t length) {
+  /*!
+   * @brief     Add an entry to the queue
+   * @param[in] operation MB85_READ or MB85_WRITE
+   * @param[in] addr Memory address
+   * @param[in] buffer Buffer to read to or write from
+   * @param[in] length Number of bytes
+   * @return    true if the entry was queued, false if the queue is full or the length is 0
+   */
+  if (_Count == MB85_BATCH_ENTRIES || length == 0) return false;
+  _Entry[_Count].address   = addr;
+  _Entry[_Count].buffer    = buffer;
+  _Entry[_Count].length    = length;
+  _Entry[_Count].operation = operation;
+  _Order[_Count]           = _Count;
+  _Count++;
+  _Sorted = false;
+  return true;
+}  // of method queue()
+void MB85_FRAM_Batch::sort() {
+  /*!
+   * @brief     Sort the entry indices by address with an insertion sort, which is stable and fast
+   *            for the few entries of a batch
+   */
+  for (uint8_t i = 1; i < _Count; i++) {
+    uint8_t index = _Order[i];
+    uint8_t j     = i;
+    for (; j > 0 && _Entry[_Order[j - 1]].address > _Entry[index].address; j--) {
+      _Order[j] = _Order[j - 1];
+    }  // of for-next each larger address
+    _Order[j] = index;
+  }  // of for-next each entry
+  _Sorted = true;
+}  // of method sort()
+uint8_t MB85_FRAM_Batch::transfer(const MB85_Operation operation) {
+  /*!
+   * @brief     Transfer the entries of one operation, merging neighbouring entries
+   * @details   Going through the entries in address order, each range is extended by the
+   *            following entries as long as they start within it, or within MB85_BATCH_GAP bytes
+   *            of its end for reads, and it fits into the bounce buffer. A range of one entry is
+   *            transferred directly from or to the entry's buffer, as is an entry longer than the
+   *            bounce buffer, to which only reads lying completely within it are added. The writes
+   *            of a range are copied into the bounce buffer in the order they were queued.
+   * @param[in] operation MB85_READ or MB85_WRITE
+   * @return    Number of entries whose bytes were all transferred
+   */
+  uint8_t  bounce[MB85_BOUNCE_SIZE];    // Merged range of several entries
+  uint8_t  member[MB85_BATCH_ENTRIES];  // Indices of the entries in the range
+  uint8_t  done = 0;                    // Entries completely transferred
+  uint32_t gap  = operation == MB85_READ ? MB85_BATCH_GAP : 0;
+  for (uint8_t next = 0; next < _Count;) {
+    uint8_t          first = _Order[next++];
+    MB85_BatchEntry &head  = _Entry[first];
+    if (head.operation != operation) continue;
+    uint8_t  members = 1;
+    uint32_t start   = head.address;
+    uint32_t end     = start + head.length;
+    bool     direct  = head.length > sizeof(bounce);  // Too long for the bounce buffer
+    member[0]        = first;
+    for (; next < _Count; next++) {
+      MB85_BatchEntry &entry = _Entry[_Order[next]];
+      if (entry.operation != operation) continue;
+      uint32_t last = entry.address + entry.length > end ? entry.address + entry.length : end;
+      if (entry.address > end + gap) break;                           // Too far away
+      if (direct && (operation == MB85_WRITE || last != end)) break;  // Not within entry
+      if (!direct && last - start > sizeof(bounce)) break;            // Range too long
+      member[members++] = _Order[next];
+      end               = last;
+    }  // of for-next each following entry
+    uint8_t *data = direct || members == 1 ? head.buffer : bounce;
+    if (operation == MB85_WRITE && data == bounce) {
+      for (uint8_t index = 0; index < _Count; index++) {  // Queue order, so the last write wins
+        for (uint8_t i = 0; i < members; i++) {
+          if (member[i] == index) {
+            memcpy(bounce + (_Entry[index].address - start), _Entry[index].buffer,
+                   _Entry[index].length);
+          }  // of if-then entry is in the range
+        }    // of for-next each member
+      }      // of for-next each queued entry
+    }        // of if-then merged writes
+    uint32_t bytes = operation == MB85_READ ? _FRAM.readBlock(start, data, end - start)
+                                            : _FRAM.writeBlock(start, data, end - start);
+    for (uint8_t i = 0; i < members; i++) {
+      MB85_BatchEntry &entry  = _Entry[member[i]];
+      uint32_t         offset = entry.address - start;
+      if (offset + entry.length > bytes) continue;  // Not completely transferred
+      if (operation == MB85_READ && entry.buffer != data) {
+        memcpy(entry.buffer, data + offset, entry.length);
+      }  // of if-then copy from the merged range
+      done++;
+    }  // of for-next each member
+  }    // of for-next each range
+  return done;
+}  // of method transfer()
@@ -0,0 +1,85 @@
+/*! @file MB85_FRAM_Batch.h
+ @section MB85_FRAM_Batch_intro_section Description
+
+ Queue of scattered reads and writes on an MB85_FRAM_Class instance which are transferred together
+ by execute(). Each read() or write() call costs its own address phase, so a control cycle which
+ reads or writes a dozen small fields takes up to two dozen I2C transactions. The batch instead
+ sorts the queued entries by memory address, which also groups them by memory, and merges reads of
+ adjacent or overlapping ranges, or of ranges separated by a gap of at most MB85_BATCH_GAP bytes,
+ into one read of up to MB85_BOUNCE_SIZE bytes from which the values are copied. Writes of adjacent
+ or overlapping ranges are merged the same way, without gaps, and overlapping bytes take the value
+ of the entry queued last, except for writes longer than MB85_BOUNCE_SIZE bytes, which are written
+ on their own in address order. The merged ranges are transferred by readBlock() and writeBlock(),
+ which split them at memory boundaries as usual.\n\n
+
+ All reads are done before the writes, so reads return the memory contents from before the batch.
+ The entries stay queued after execute() and are sorted only once, so the same fields can be
+ transferred in every cycle by calling execute() again until clear() is called. The buffers of
+ the entries are used by execute() and need to stay valid until then. See main library header file
+ for details
+*/
+#ifndef MB85_FRAM_BATCH
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_BATCH
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+const uint8_t MB85_BATCH_ENTRIES{16};  ///< Maximum number of queued entries
+/*! @brief  Largest gap bridged between two reads, fewer than the bytes of a new address phase */
+const uint8_t MB85_BATCH_GAP{4};
+
+/*! @brief  One queued read or write */
+struct MB85_BatchEntry {
+  uint32_t       address;    ///< First memory address
+  uint8_t       *buffer;     ///< Buffer to read to or write from
+  uint16_t       length;     ///< Bytes to transfer
+  MB85_Operation operation;  ///< MB85_READ or MB85_WRITE
+};
+
+class MB85_FRAM_Batch {
+  /*!
+   * @class   MB85_FRAM_Batch
+   * @brief   Scatter/gather queue of reads and writes merged into as few transfers as possible
+   */
+ public:
+  MB85_FRAM_Batch(MB85_FRAM_Class &fram);
+  bool    queueRead(const uint32_t addr, uint8_t *buffer, const uint16_t length);
+  bool    queueWrite(const uint32_t addr, const uint8_t *buffer, const uint16_t length);
+  uint8_t execute();
+  uint8_t queued() const;
+  void    clear();
+
+  template <typename T>
+  bool queueRead(const uint32_t addr, T &value) {
+    /*!
+      @brief     Queue a read of a value of any type
+      @param[in] addr Memory address
+      @param[in] value Value to read to, needs to stay valid until execute()
+      @return    true if the read was queued, false if the queue is full
+    */
+    return queueRead(addr, (uint8_t *)&value, sizeof(T));
+  }  // of method queueRead()
+
+  template <typename T>
+  bool queueWrite(const uint32_t addr, const T &value) {
+    /*!
+      @brief     Queue a write of a value of any type
+      @param[in] addr Memory address
+      @param[in] value Value to write, read by execute() and needs to stay valid until then
+      @return    true if the write was queued, false if the queue is full
+    */
+    return queueWrite(addr, (const uint8_t *)&value, sizeof(T));
+  }  // of method queueWrite()
+
+ private:
+  bool    queue(const MB85_Operation operation, const uint32_t addr, uint8_t *buffer,
+                const uint16_t length);
+  void    sort();
+  uint8_t transfer(const MB85_Operation operation);
+
+  MB85_FRAM_Class &_FRAM;                         ///< Memory accessed
+  MB85_BatchEntry  _Entry[MB85_BATCH_ENTRIES];    ///< Entries in the order they were queued
+  uint8_t          _Order[MB85_BATCH_ENTRIES];    ///< Entry indices sorted by address
+  uint8_t          _Count  = 0;                   ///< Number of queued entries
+  bool             _Sorted = true;                ///< Set while "_Order" is up to date
+};                                                // of class MB85_FRAM_Batch
+#endif
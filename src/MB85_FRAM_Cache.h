@@ -0,0 +1,294 @@
+/*! @file MB85_FRAM_Cache.h
+ @section MB85_FRAM_Cache_intro_section Description
+
+ Optional write-back cache which sits in front of an MB85_FRAM_Class instance. Firmware which
+ updates many small fields and counters with scattered write() calls spends most of the I2C bus
+ time sending slave and memory addresses, the cache keeps recently used memory in RAM instead and
+ only sends the changed bytes back to the memory on flush() or when a cache line is evicted.\n\n
+
+ The cache is a template with the number of lines and the line size as parameters, so that the RAM
+ used can be chosen to suit the processor. The default of 4 lines of 16 bytes uses less than 100
+ bytes of RAM. Each line holds a line-aligned block of memory and keeps track of the range of bytes
+ which have been changed. When writing back, the changed ranges of lines which follow each other in
+ memory are joined and sent in as few I2C transmissions as the Wire buffer allows. As the FRAM has
+ no write latency a cache line is written back in one burst and there is never a need to wait.\n\n
+
+ The cache only sees accesses made through it, so any direct access to the memory through the
+ MB85_FRAM_Class instance should be preceded by a call to flush() and followed by invalidate().
+ The cache is meant for small scattered accesses, large blocks are better read and written through
+ MB85_FRAM_Class directly. See main library header file for details
+*/
+#ifndef MB85_FRAM_CACHE
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_CACHE
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+const uint32_t MB85_CACHE_EMPTY{UINT32_MAX};  ///< Tag value of an unused cache line
+
+template <uint8_t LINES = 4, uint8_t LINE_SIZE = 16>
+class MB85_FRAM_Cache {
+  /*!
+   * @class   MB85_FRAM_Cache
+   * @brief   Write-back RAM cache for an MB85_FRAM_Class instance
+   * @tparam  LINES Number of cache lines
+   * @tparam  LINE_SIZE Bytes in each cache line, a power of 2 up to 128
+   */
+  static_assert(LINES > 0, "MB85_FRAM_Cache needs at least one line");
+  static_assert(LINE_SIZE >= 2 && LINE_SIZE <= 128 && (LINE_SIZE & (LINE_SIZE - 1)) == 0,
+                "MB85_FRAM_Cache line size must be a power of 2 from 2 to 128");
+
+ public:
+  explicit MB85_FRAM_Cache(MB85_FRAM_Class &fram) : _FRAM(fram) {
+    /*!
+     * @brief     Class constructor
+     * @param[in] fram Memory to cache, begin() needs to have been called before the first access
+     */
+    for (uint8_t i = 0; i < LINES; i++) _Age[i] = i;  // Give each line a distinct age
+    invalidate();                                     // Start with all lines empty
+  }  // of class constructor
+  ~MB85_FRAM_Cache() {
+    /*!
+     * @brief   Class destructor
+     * @details Writes back all changed data
+     */
+    flush();
+  }  // of class destructor
+  template <typename T>
+  uint32_t read(const uint32_t addr, T &value) {
+    /*!
+      @brief     Read any data type through the cache
+      @param[in] addr Memory address
+      @param[out] value Data Type "T" to read
+      @return    Number of bytes read
+    */
+    return readBlock(addr, (uint8_t *)&value, sizeof(T));
+  }  // of method read()
+  template <typename T>
+  uint32_t write(const uint32_t addr, const T &value) {
+    /*!
+      @brief     Write any data type through the cache
+      @param[in] addr Memory address
+      @param[in] value Data Type "T" to write
+      @return    Number of bytes written
+    */
+    return writeBlock(addr, (const uint8_t *)&value, sizeof(T));
+  }  // of method write()
+  uint32_t readBlock(const uint32_t addr, uint8_t *buffer, const uint32_t length) {
+    /*!
+      @brief     Read a block of bytes through the cache
+      @details   Bytes in cached lines are copied from RAM, for every other line touched the whole
+                 line is read from memory in a single burst and kept in the cache
+      @param[in] addr Memory address
+      @param[out] buffer Buffer to read to
+      @param[in] length Number of bytes to read
+      @return    Number of bytes read, less than "length" if a line couldn't be read or written
+    */
+    uint32_t total = _FRAM.totalBytes();
+    if (total == 0) return 0;                                  // No memory, so nothing to do
+    uint32_t memAddress = addr < total ? addr : addr % total;  // Wrap if needed
+    uint32_t bytesRead  = 0;
+    while (bytesRead < length) {                                  // Loop through each line touched
+      uint32_t base   = memAddress & ~(uint32_t)(LINE_SIZE - 1);  // Start of the cache line
+      uint8_t  offset = memAddress - base;                        // Offset in the cache line
+      uint32_t bytes  = LINE_SIZE - offset;                       // Bytes in this line
+      if (bytes > length - bytesRead) bytes = length - bytesRead;
+      int16_t line = findLine(base);
+      if (line < 0) line = loadLine(base, true);                // Read the line on a miss
+      if (line < 0) break;                                      // Memory failed
+      memcpy(buffer + bytesRead, _Data[line] + offset, bytes);  // Copy from the cache
+      bytesRead += bytes;
+      memAddress += bytes;
+      if (memAddress >= total) memAddress = 0;  // Wrap around at the end of memory
+    }                                           // of while bytes left to read
+    return bytesRead;
+  }  // of method readBlock()
+  uint32_t writeBlock(const uint32_t addr, const uint8_t *buffer, const uint32_t length) {
+    /*!
+      @brief     Write a block of bytes through the cache
+      @details   The bytes are stored in the cache and marked as changed. A line that isn't cached
+                 is read from memory first, unless the whole line is being overwritten
+      @param[in] addr Memory address
+      @param[in] buffer Buffer to write from
+      @param[in] length Number of bytes to write
+      @return    Number of bytes written, less than "length" if a line couldn't be read or written
+    */
+    uint32_t total = _FRAM.totalBytes();
+    if (total == 0) return 0;                                    // No memory, so nothing to do
+    uint32_t memAddress   = addr < total ? addr : addr % total;  // Wrap if needed
+    uint32_t bytesWritten = 0;
+    while (bytesWritten < length) {                               // Loop through each line touched
+      uint32_t base   = memAddress & ~(uint32_t)(LINE_SIZE - 1);  // Start of the cache line
+      uint8_t  offset = memAddress - base;                        // Offset in the cache line
+      uint32_t bytes  = LINE_SIZE - offset;                       // Bytes in this line
+      if (bytes > length - bytesWritten) bytes = length - bytesWritten;
+      int16_t line = findLine(base);
+      if (line < 0) line = loadLine(base, bytes != LINE_SIZE);  // Only read partial lines
+      if (line < 0) break;                                      // Memory failed
+      memcpy(_Data[line] + offset, buffer + bytesWritten, bytes);
+      if (offset < _DirtyLow[line]) _DirtyLow[line] = offset;  // Extend the changed range
+      if (offset + bytes - 1 > _DirtyHigh[line]) _DirtyHigh[line] = offset + bytes - 1;
+      bytesWritten += bytes;
+      memAddress += bytes;
+      if (memAddress >= total) memAddress = 0;  // Wrap around at the end of memory
+    }                                           // of while bytes left to write
+    return bytesWritten;
+  }  // of method writeBlock()
+  uint32_t flush() {
+    /*!
+      @brief   Write all changed bytes back to memory
+      @details Lines which couldn't be written completely keep their changed bytes, so they are
+               written again by the next flush()
+      @return  Number of bytes written to memory
+    */
+    uint32_t bytesWritten = 0;
+    for (uint8_t i = 0; i < LINES; i++) {
+      if (isDirty(i)) bytesWritten += writeRun(i);  // Write the run this line belongs to
+    }                                               // of for-next each line
+    return bytesWritten;
+  }  // of method flush()
+  void invalidate() {
+    /*!
+      @brief   Discard the contents of the cache without writing changed bytes back
+    */
+    for (uint8_t i = 0; i < LINES; i++) {
+      _Tag[i] = MB85_CACHE_EMPTY;
+      markClean(i);
+    }  // of for-next each line
+  }  // of method invalidate()
+
+ private:
+  int16_t findLine(const uint32_t base) {
+    /*!
+      @brief     Return the cache line holding a memory line and mark it as most recently used
+      @param[in] base Line-aligned memory address
+      @return    Cache line number or -1 if the memory line isn't cached
+    */
+    for (uint8_t i = 0; i < LINES; i++) {
+      if (_Tag[i] == base) {
+        touch(i);
+        return i;
+      }  // of if-then line found
+    }    // of for-next each line
+    return -1;
+  }  // of method findLine()
+  int16_t loadLine(const uint32_t base, const bool fill) {
+    /*!
+      @brief     Place a memory line into the cache, evicting the least recently used line
+      @details   A line whose changed bytes can't be written back isn't evicted, and a line which
+                 can't be read completely is left empty, so that neither changed nor wrong data is
+                 ever served
+      @param[in] base Line-aligned memory address
+      @param[in] fill Read the line contents from memory when set
+      @return    Cache line number, -1 if the memory failed
+    */
+    uint8_t line = 0;
+    for (uint8_t i = 1; i < LINES; i++) {
+      if (_Age[i] > _Age[line]) line = i;  // Find the least recently used line
+    }                                      // of for-next each line
+    if (isDirty(line)) writeRun(line);     // Write back changed bytes
+    if (isDirty(line)) return -1;          // and keep them if that failed
+    _Tag[line] = MB85_CACHE_EMPTY;
+    touch(line);
+    if (fill && _FRAM.readBlock(base, _Data[line], LINE_SIZE) != LINE_SIZE) return -1;
+    _Tag[line] = base;  // Line holds the memory contents
+    return line;
+  }  // of method loadLine()
+  uint32_t writeRun(const uint8_t line) {
+    /*!
+      @brief     Write back the changed bytes of a line together with those of adjacent lines
+      @details   Lines whose changed ranges touch across a line boundary form one run of changed
+                 bytes in memory. The run is collected into a buffer the size of one I2C write and
+                 each full buffer is sent as one transmission. The lines are only marked as clean
+                 once the whole run has been written.
+      @param[in] line Cache line with changed bytes
+      @return    Number of bytes written to memory
+    */
+    uint8_t  buffer[BUFFER_LENGTH - 2];  // One I2C transmission of data
+    uint8_t  used         = 0;           // Bytes in the buffer
+    uint32_t bytesWritten = 0;
+    int16_t  current      = line;
+    int16_t  previous     = line;
+    while (previous >= 0) {  // Find the first line of the run
+      current  = previous;
+      previous = _DirtyLow[current] == 0 ? findDirty(_Tag[current] - LINE_SIZE) : -1;
+      if (previous >= 0 && _DirtyHigh[previous] != LINE_SIZE - 1) previous = -1;
+    }                                                       // of while run continues backwards
+    uint32_t address = _Tag[current] + _DirtyLow[current];  // Start of the run in memory
+    uint32_t wanted  = 0;                                   // Changed bytes in the run
+    int16_t  first   = current;                             // First line of the run
+    while (current >= 0) {                                  // Collect each line of the run
+      for (uint8_t i = _DirtyLow[current]; i <= _DirtyHigh[current]; i++) {
+        buffer[used++] = _Data[current][i];
+        if (used == sizeof(buffer)) {  // Send each full buffer
+          bytesWritten += _FRAM.writeBlock(address, buffer, used);
+          address += used;
+          used = 0;
+        }  // of if-then buffer full
+      }    // of for-next each changed byte
+      wanted += _DirtyHigh[current] - _DirtyLow[current] + 1;
+      current = nextInRun(current);
+    }  // of while run continues forwards
+    if (used) bytesWritten += _FRAM.writeBlock(address, buffer, used);
+    if (bytesWritten != wanted) return bytesWritten;  // Keep the run changed to write it again
+    for (current = first; current >= 0;) {
+      int16_t next = nextInRun(current);  // Find the next line before this one is clean
+      markClean(current);
+      current = next;
+    }  // of for-next each line of the run
+    return bytesWritten;
+  }  // of method writeRun()
+  int16_t nextInRun(const uint8_t line) {
+    /*!
+      @brief     Return the next line of a run of changed bytes
+      @param[in] line Cache line in the run
+      @return    Cache line number or -1 if the run ends with this line
+    */
+    if (_DirtyHigh[line] != LINE_SIZE - 1) return -1;  // Changed bytes end before the line
+    int16_t next = findDirty(_Tag[line] + LINE_SIZE);
+    return next >= 0 && _DirtyLow[next] == 0 ? next : -1;
+  }  // of method nextInRun()
+  int16_t findDirty(const uint32_t base) {
+    /*!
+      @brief     Return the cache line holding a memory line if it has changed bytes
+      @param[in] base Line-aligned memory address
+      @return    Cache line number or -1 if the memory line isn't cached or unchanged
+    */
+    for (uint8_t i = 0; i < LINES; i++) {
+      if (_Tag[i] == base && isDirty(i)) return i;
+    }  // of for-next each line
+    return -1;
+  }  // of method findDirty()
+  void touch(const uint8_t line) {
+    /*!
+      @brief     Mark a cache line as the most recently used
+      @param[in] line Cache line number
+    */
+    for (uint8_t i = 0; i < LINES; i++) {
+      if (_Age[i] < _Age[line]) _Age[i]++;
+    }  // of for-next each line
+    _Age[line] = 0;
+  }  // of method touch()
+  bool isDirty(const uint8_t line) const {
+    /*!
+      @brief     Check whether a cache line has changed bytes
+      @param[in] line Cache line number
+      @return    true if the line has changed bytes
+    */
+    return _DirtyLow[line] <= _DirtyHigh[line];
+  }  // of method isDirty()
+  void markClean(const uint8_t line) {
+    /*!
+      @brief     Mark a cache line as having no changed bytes
+      @param[in] line Cache line number
+    */
+    _DirtyLow[line]  = LINE_SIZE;
+    _DirtyHigh[line] = 0;
+  }  // of method markClean()
+  MB85_FRAM_Class &_FRAM;                    ///< Memory being cached
+  uint32_t         _Tag[LINES];              ///< Memory address of each line
+  uint8_t          _Data[LINES][LINE_SIZE];  ///< Contents of each line
+  uint8_t          _DirtyLow[LINES];         ///< First changed byte, LINE_SIZE when clean
+  uint8_t          _DirtyHigh[LINES];        ///< Last changed byte, 0 when clean
+  uint8_t          _Age[LINES];              ///< Accesses since each line was last used
+};                                           // of MB85_FRAM_Cache class definition
+#endif
@@ -0,0 +1,258 @@
+/*! @file MB85_FRAM_Fixed.h
+ @section MB85_FRAM_Fixed_intro_section Description
+
+ Compile-time variant of MB85_FRAM_Class for hardware where the memories are known in advance. The
+ memory types are given as template parameters, e.g. "MB85_FRAM_Fixed<MB85RC256V, MB85RC256V>", and
+ the memories are expected at consecutive I2C addresses starting at MB85_MIN_ADDRESS, with an
+ MB85RC1MT or MB85RC04V taking up 2 and an MB85RC16 all 8 slave addresses. As all sizes
+ are constants the compiler reduces the wraparound at the end of memory to a mask when the total
+ size is a power of 2, finds the memory for an address with a shift when all memories are the same
+ size and removes the handling of memory boundaries which can't occur, e.g. with a single memory.
+ There is no detection of the memories on the I2C bus, no translation table in RAM and no
+ asynchronous queue, so both flash and RAM use are much smaller than those of MB85_FRAM_Class.\n\n
+
+ The I2C transactions are performed by MB85_FRAM_Class::transferI2C(), so both classes send the
+ same data on the bus, repeat failed transactions setRetries() times and keep the same bus usage
+ counters after attachStats(). See main library header file for details
+*/
+#ifndef MB85_FRAM_FIXED
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_FIXED
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+/*! @brief  Return the number of bytes in a list of memory types */
+constexpr uint32_t MB85_layoutBytes() { return 0; }
+/*! @brief  Return the number of bytes in a list of memory types */
+template <typename... REST>
+constexpr uint32_t MB85_layoutBytes(const MB85_Type first, const REST... rest) {
+  return MB85_typeBytes(first) + MB85_layoutBytes(rest...);
+}
+/*! @brief  Return the number of I2C slave addresses used by a list of memory types */
+constexpr uint8_t MB85_layoutSlaves() { return 0; }
+/*! @brief  Return the number of I2C slave addresses used by a list of memory types */
+template <typename... REST>
+constexpr uint8_t MB85_layoutSlaves(const MB85_Type first, const REST... rest) {
+  return MB85_slaveCount(first) + MB85_layoutSlaves(rest...);
+}
+/*! @brief  Return true if all memory types in a list are present, i.e. not MB85_NONE */
+constexpr bool MB85_layoutPresent() { return true; }
+/*! @brief  Return true if all memory types in a list are present, i.e. not MB85_NONE */
+template <typename... REST>
+constexpr bool MB85_layoutPresent(const MB85_Type first, const REST... rest) {
+  return first != MB85_NONE && MB85_layoutPresent(rest...);
+}
+/*! @brief  Return true if all memory types in a list are the same */
+constexpr bool MB85_layoutEqual(const MB85_Type) { return true; }
+/*! @brief  Return true if all memory types in a list are the same */
+template <typename... REST>
+constexpr bool MB85_layoutEqual(const MB85_Type first, const MB85_Type second,
+                                const REST... rest) {
+  return first == second && MB85_layoutEqual(second, rest...);
+}
+/*! @brief  Return the base 2 logarithm of a power of 2 */
+constexpr uint8_t MB85_log2(const uint32_t value) {
+  return value <= 1 ? 0 : 1 + MB85_log2(value / 2);
+}
+
+template <MB85_Type... TYPES>
+class MB85_FRAM_Fixed {
+  /*!
+   * @class   MB85_FRAM_Fixed
+   * @brief   Access a fixed set of MB85 memories on one I2C bus
+   * @tparam  TYPES Memory types in I2C address order from MB85_MIN_ADDRESS onwards
+   */
+  static_assert(sizeof...(TYPES) >= 1, "MB85_FRAM_Fixed needs at least one memory");
+  static_assert(MB85_layoutPresent(TYPES...), "MB85_FRAM_Fixed memories can't be MB85_NONE");
+  static_assert(MB85_layoutSlaves(TYPES...) <= MB85_MAX_DEVICES,
+                "MB85_FRAM_Fixed memories need more than 8 slave addresses");
+
+ public:
+  static constexpr uint8_t  CHIPS      = sizeof...(TYPES);             ///< Number of memories
+  static constexpr uint32_t TOTAL      = MB85_layoutBytes(TYPES...);   ///< Bytes in all memories
+  static constexpr bool     UNIFORM    = MB85_layoutEqual(TYPES...);   ///< Memories are all equal
+  static constexpr bool     POWER_OF_2 = (TOTAL & (TOTAL - 1)) == 0;   ///< Total is a power of 2
+  static constexpr uint8_t  CHIP_SHIFT = MB85_log2(TOTAL / CHIPS);     ///< log2 of equal sizes
+
+  explicit MB85_FRAM_Fixed(TwoWire &bus = Wire) : _Bus(bus) {
+    /*!
+     * @brief     Class constructor
+     * @param[in] bus I2C bus the memories are attached to, defaults to "Wire"
+     */
+  }  // of class constructor
+  uint8_t begin(const uint32_t i2cSpeed = I2C_STANDARD_MODE) {
+    /*!
+      @brief     Start the I2C bus, the memories are not checked
+      @param[in] i2cSpeed I2C Bus speed in Herz
+      @return    Number of memories
+    */
+    _Bus.begin();
+    _Bus.setClock(i2cSpeed);
+    _Clock = i2cSpeed;
+    return CHIPS;
+  }  // of method begin()
+  static constexpr uint32_t totalBytes() {
+    /*!
+      @brief   Return the total memory available in all memories
+      @return  Total number of bytes
+    */
+    return TOTAL;
+  }  // of method totalBytes()
+  uint32_t memSize(const uint8_t memNumber) const {
+    /*!
+      @brief     Return the size of one memory
+      @param[in] memNumber Memory index
+      @return    Memory size in bytes, 0 if out of range
+    */
+    return memNumber < CHIPS ? MB85_typeBytes(_Types[memNumber]) : 0;
+  }  // of method memSize()
+  uint8_t status() const {
+    /*!
+      @brief     Return the status of the last I2C transaction, as for MB85_FRAM_Class::status()
+      @return    Status of the last transaction, 0 on success
+    */
+    return _Status;
+  }  // of method status()
+  void setRetries(const uint8_t retries) {
+    /*!
+      @brief     Set how often a failed I2C transaction is repeated before the transfer is ended
+      @param[in] retries Number of repeats, MB85_RETRIES by default and 0 to disable
+    */
+    _Retries = retries;
+  }  // of method setRetries()
+  void attachStats(MB85_Stats stats[]) {
+    /*!
+      @brief     Start keeping bus usage counters for each memory
+      @details   The counters are cleared, the array needs CHIPS entries in I2C address order
+      @param[in] stats Array of counters, nullptr to stop counting
+    */
+    _Stats = stats;
+    if (_Stats != nullptr) memset(_Stats, 0, CHIPS * sizeof(MB85_Stats));
+  }  // of method attachStats()
+  uint32_t busMicros(const uint8_t memNumber) const {
+    /*!
+      @brief     Return the bus time used by a memory since attachStats() was called
+      @param[in] memNumber Memory index
+      @return    Bus time in microseconds rounded down, 0 if no counters are kept
+    */
+    if (_Stats == nullptr || memNumber >= CHIPS || _Clock == 0) return 0;
+    return (uint32_t)(_Stats[memNumber].clocks * 1000000 / _Clock);
+  }  // of method busMicros()
+  template <typename T>
+  uint32_t read(const uint32_t addr, T &value) {
+    /*!
+      @brief     Read any data type from memory
+      @param[in] addr Memory address
+      @param[out] value Data Type "T" to read
+      @return    Number of bytes read
+    */
+    return transfer(MB85_READ, addr, (uint8_t *)&value, sizeof(T));
+  }  // of method read()
+  template <typename T>
+  uint32_t write(const uint32_t addr, const T &value) {
+    /*!
+      @brief     Write any data type to memory
+      @param[in] addr Memory address
+      @param[in] value Data Type "T" to write
+      @return    Number of bytes written
+    */
+    return transfer(MB85_WRITE, addr, (uint8_t *)&value, sizeof(T));
+  }  // of method write()
+  uint32_t readBlock(const uint32_t addr, uint8_t *buffer, const uint32_t length) {
+    /*!
+      @brief     Read a block of bytes from memory
+      @param[in] addr Memory address
+      @param[out] buffer Buffer to read to
+      @param[in] length Number of bytes to read
+      @return    Number of bytes read
+    */
+    return transfer(MB85_READ, addr, buffer, length);
+  }  // of method readBlock()
+  uint32_t writeBlock(const uint32_t addr, const uint8_t *buffer, const uint32_t length) {
+    /*!
+      @brief     Write a block of bytes to memory
+      @param[in] addr Memory address
+      @param[in] buffer Buffer to write from
+      @param[in] length Number of bytes to write
+      @return    Number of bytes written
+    */
+    return transfer(MB85_WRITE, addr, (uint8_t *)buffer, length);
+  }  // of method writeBlock()
+
+ private:
+  static uint32_t wrap(const uint32_t address) {
+    /*!
+      @brief     Wrap a memory address around to the memory size
+      @param[in] address Memory address
+      @return    Address in the range 0 to TOTAL - 1
+    */
+    return POWER_OF_2 ? address & (TOTAL - 1) : address < TOTAL ? address : address % TOTAL;
+  }  // of method wrap()
+  static uint8_t locate(uint32_t &address, uint32_t &chipBytes, uint8_t &slave) {
+    /*!
+      @brief     Find the memory for an address
+      @param[in,out] address Memory address, returned as the address on the memory
+      @param[out] chipBytes Bytes from the address to the end of the memory
+      @param[out] slave First I2C slave address of the memory
+      @return    Memory index
+    */
+    uint8_t device = 0;
+    if (UNIFORM) {
+      device  = address >> CHIP_SHIFT;                 // All memories are the same size
+      address = address & ((1UL << CHIP_SHIFT) - 1);  // Address on the memory
+      slave   = MB85_MIN_ADDRESS + device * MB85_slaveCount(_Types[0]);
+    } else {
+      slave = MB85_MIN_ADDRESS;
+      while (address >= MB85_typeBytes(_Types[device])) {
+        address -= MB85_typeBytes(_Types[device]);  // Skip to the next memory
+        slave += MB85_slaveCount(_Types[device++]);
+      }  // of while address past the memory
+    }    // of if-then-else all memories equal
+    chipBytes = MB85_typeBytes(_Types[device]) - address;
+    return device;
+  }  // of method locate()
+  uint32_t transfer(const MB85_Operation operation, const uint32_t addr, uint8_t *buffer,
+                    const uint32_t length) {
+    /*!
+      @brief     Read or write a block of bytes
+      @details   The memory address is only sent once for each memory read from, the following
+                 reads continue from the memory's internal address counter
+      @param[in] operation Read or write
+      @param[in] addr Memory address
+      @param[in,out] buffer Buffer to read to or write from
+      @param[in] length Number of bytes
+      @return    Number of bytes transferred
+    */
+    uint32_t memAddress = wrap(addr);  // Wrap if needed
+    uint32_t done       = 0;           // Bytes transferred
+    while (done < length) {
+      uint32_t chipAddress = memAddress;  // Address on the memory chip
+      uint32_t chipBytes;                 // Bytes left on this chip
+      uint8_t  slave;                     // I2C address of the chip
+      uint8_t  device = locate(chipAddress, chipBytes, slave);
+      if (chipBytes > length - done) chipBytes = length - done;
+      for (uint32_t i = 0; i < chipBytes;) {  // Loop through each I2C buffer
+        bool    page  = i == 0 || MB85_pageBytes(_Types[device], chipAddress + i) ==
+                                    MB85_pageBytes(_Types[device], 0);  // Slave address changed
+        uint8_t chunk = MB85_FRAM_Class::transferI2C(
+            _Bus, slave, _Types[device], chipAddress + i, operation, buffer + done, 0,
+            chipBytes - i, operation != MB85_READ || page, _Status, _Retries,
+            _Stats == nullptr ? nullptr : &_Stats[device]);
+        if (chunk == 0) return done;  // Stop if the device didn't respond
+        done += chunk;
+        i += chunk;
+      }  // of for-next each I2C buffer
+      memAddress = wrap(memAddress + chipBytes);  // Continue on the next chip
+    }                                           // of while bytes left to transfer
+    return done;
+  }  // of method transfer()
+  static constexpr MB85_Type _Types[CHIPS] = {TYPES...};  ///< Memory types in address order
+  TwoWire                   &_Bus;                        ///< I2C bus of the memories
+  uint32_t                   _Clock   = 0;                ///< I2C clock in Hz
+  MB85_Stats                *_Stats   = nullptr;          ///< Counters, nullptr if not kept
+  uint8_t                    _Retries = MB85_RETRIES;     ///< Repeats of a failed transaction
+  uint8_t                    _Status  = 0;                ///< Wire status of the last transaction
+};  // of class MB85_FRAM_Fixed
+
+template <MB85_Type... TYPES>
+constexpr MB85_Type MB85_FRAM_Fixed<TYPES...>::_Types[];  ///< Storage for the memory types
+#endif
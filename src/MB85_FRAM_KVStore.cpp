@@ -0,0 +1,255 @@
+/*! @file MB85_FRAM_KVStore.cpp
+ @section MB85_FRAM_KVStore_cpp_intro_section Description
+
+ Implementation of the MB85_FRAM_KVStore class, see MB85_FRAM_KVStore.h for details
+*/
+#include "MB85_FRAM_KVStore.h"  // Include the header definition
+
+MB85_FRAM_KVStore::MB85_FRAM_KVStore(MB85_FRAM_Class &fram, const uint32_t start,
+                                     const uint16_t buckets, const uint8_t valueSize,
+                                     uint8_t fingerprints[])
+    : _FRAM(fram),
+      _Start(start),
+      _Buckets(buckets),
+      _ValueSize(valueSize < MB85_KV_MAX_VALUE ? valueSize : MB85_KV_MAX_VALUE),
+      _Fingerprints(fingerprints),
+      _Records(0),
+      _Ready(false) {
+  /*!
+   * @brief     Class constructor
+   * @details   Leaving a quarter of the buckets unused keeps the probe sequences short
+   * @param[in] fram Memory holding the store, begin() needs to have been called on it first
+   * @param[in] start Memory address of the store region, which takes regionBytes() bytes
+   * @param[in] buckets Number of buckets, which is the maximum number of records
+   * @param[in] valueSize Maximum value length in bytes, limited to MB85_KV_MAX_VALUE
+   * @param[in] fingerprints Optional array of "buckets" bytes for the fingerprints in RAM
+   */
+}  // of class constructor
+bool MB85_FRAM_KVStore::begin(const bool format) {
+  /*!
+   * @brief     Find the store in the memory or format it
+   * @details   The header of every bucket is read once to count the records and to fill the
+   *            fingerprints. The store is formatted when the header is invalid, the layout has
+   *            changed or "format" is set, in which case the buckets are cleared before the header
+   *            is written, so a power failure while formatting is repeated at the next begin().
+   *            A header which can't be read never causes a format, as that would erase a store
+   *            which is only unreachable for the moment.
+   * @param[in] format Discard any existing records
+   * @return    true if the store is ready, false if the region doesn't fit into the memory or the
+   *            memory couldn't be read
+   */
+  _Ready = false;
+  if (_Buckets == 0 || _ValueSize == 0) return false;
+  if (_Start + regionBytes() > _FRAM.totalBytes()) return false;
+  MB85_KVHeader header;
+  if (!format && _FRAM.read(_Start, header) != sizeof(header)) return false;  // Don't format
+  if (format || header.magic != MB85_KV_MAGIC || header.buckets != _Buckets ||
+      header.valueSize != _ValueSize ||
+      header.crc != MB85_crc16((const uint8_t *)&header, offsetof(MB85_KVHeader, crc))) {
+    _Ready = true;  // Needed by clear()
+    memset(&header, 0, sizeof(header));
+    header.magic     = MB85_KV_MAGIC;
+    header.buckets   = _Buckets;
+    header.valueSize = _ValueSize;
+    header.crc       = MB85_crc16((const uint8_t *)&header, offsetof(MB85_KVHeader, crc));
+    _Ready           = clear() && _FRAM.write(_Start, header) == sizeof(header);
+    return _Ready;
+  }  // of if-then format
+  _Records = 0;
+  for (uint16_t i = 0; i < _Buckets; i++) {
+    MB85_KVRecord record;
+    if (_FRAM.read(bucketAddress(i), record) != sizeof(record)) return false;
+    if (record.state == MB85_KV_USED) _Records++;
+    if (_Fingerprints != nullptr) {
+      _Fingerprints[i] = record.state == MB85_KV_USED    ? fingerprint(hash(record.key))
+                         : record.state == MB85_KV_EMPTY ? 0
+                                                         : 1;
+    }  // of if-then fingerprints
+  }    // of for-next each bucket
+  _Ready = true;
+  return _Ready;
+}  // of method begin()
+bool MB85_FRAM_KVStore::put(const uint32_t key, const void *value, const uint8_t length) {
+  /*!
+   * @brief     Insert or update a record
+   * @details   An existing record is overwritten in place, a new one goes into the first deleted
+   *            or empty bucket of the probe sequence. Either way the record header and the value
+   *            are written with one write.
+   * @param[in] key Record key
+   * @param[in] value Value bytes
+   * @param[in] length Value length, 1 up to the value size given to the constructor
+   * @return    true if the record was written, false if the value is too long, the store full or
+   *            a bucket couldn't be read, in which case nothing is written
+   */
+  if (!_Ready || length == 0 || length > _ValueSize) return false;
+  uint8_t bucket[MB85_BOUNCE_SIZE];  // Record header and value
+  int32_t freeIndex = -1;            // First free bucket of the probe sequence
+  int32_t index     = find(key, bucket, &freeIndex);
+  if (index == MB85_KV_READ_ERROR) return false;  // The key might be in an unread bucket
+  bool added = index == MB85_KV_NOT_FOUND;
+  if (added) index = freeIndex;
+  if (index < 0) return false;  // Store is full
+  MB85_KVRecord record = {key, MB85_KV_USED, length, 0};
+  memcpy(bucket, &record, sizeof(record));
+  memcpy(bucket + sizeof(record), value, length);
+  record.crc = checksum(bucket);
+  memcpy(bucket + offsetof(MB85_KVRecord, crc), &record.crc, sizeof(record.crc));
+  uint16_t bytes = sizeof(record) + length;
+  if (_FRAM.writeBlock(bucketAddress(index), bucket, bytes) != bytes) return false;
+  if (added) _Records++;
+  if (_Fingerprints != nullptr) _Fingerprints[index] = fingerprint(hash(key));
+  return true;
+}  // of method put()
+uint8_t MB85_FRAM_KVStore::get(const uint32_t key, void *value, const uint8_t size) {
+  /*!
+   * @brief      Look up a record
+   * @param[in]  key Record key
+   * @param[out] value Buffer for the value
+   * @param[in]  size Size of the buffer, a longer value is cut off
+   * @return     Length of the value, 0 if the key isn't in the store, its record is damaged or a
+   *             bucket couldn't be read
+   */
+  if (!_Ready) return 0;
+  uint8_t bucket[MB85_BOUNCE_SIZE];  // Record header and value
+  if (find(key, bucket) < 0) return 0;
+  MB85_KVRecord record;
+  memcpy(&record, bucket, sizeof(record));
+  if (record.length > _ValueSize || record.crc != checksum(bucket)) return 0;  // Damaged
+  memcpy(value, bucket + sizeof(record), size < record.length ? size : record.length);
+  return record.length;
+}  // of method get()
+bool MB85_FRAM_KVStore::remove(const uint32_t key) {
+  /*!
+   * @brief     Remove a record by marking its bucket as deleted
+   * @param[in] key Record key
+   * @return    true if the record was removed, false if the key isn't in the store or a bucket
+   *            couldn't be read
+   */
+  if (!_Ready) return false;
+  uint8_t bucket[MB85_BOUNCE_SIZE];  // Record header and value
+  int32_t index = find(key, bucket);
+  if (index < 0) return false;
+  if (!_FRAM.write(bucketAddress(index) + offsetof(MB85_KVRecord, state), MB85_KV_DELETED)) {
+    return false;
+  }  // of if-then write failed
+  _Records--;
+  if (_Fingerprints != nullptr) _Fingerprints[index] = 1;
+  return true;
+}  // of method remove()
+bool MB85_FRAM_KVStore::clear() {
+  /*!
+   * @brief     Remove all records by emptying all buckets
+   * @return    true if the buckets were cleared
+   */
+  if (!_Ready) return false;
+  uint32_t bytes = regionBytes() - sizeof(MB85_KVHeader);
+  if (_FRAM.fill(bucketAddress(0), bytes, MB85_KV_EMPTY) != bytes) return false;
+  if (_Fingerprints != nullptr) memset(_Fingerprints, 0, _Buckets);
+  _Records = 0;
+  return true;
+}  // of method clear()
+uint16_t MB85_FRAM_KVStore::records() const {
+  /*!
+   * @brief     Return the number of records in the store
+   * @return    Number of records
+   */
+  return _Records;
+}  // of method records()
+uint16_t MB85_FRAM_KVStore::buckets() const {
+  /*!
+   * @brief     Return the number of buckets, which is the maximum number of records
+   * @return    Number of buckets
+   */
+  return _Buckets;
+}  // of method buckets()
+uint32_t MB85_FRAM_KVStore::regionBytes() const {
+  /*!
+   * @brief     Return the bytes taken by the store region, the header and all buckets
+   * @return    Number of bytes
+   */
+  return sizeof(MB85_KVHeader) + (uint32_t)_Buckets * (sizeof(MB85_KVRecord) + _ValueSize);
+}  // of method regionBytes()
+uint32_t MB85_FRAM_KVStore::hash(const uint32_t key) const {
+  /*!
+   * @brief     Mix the bits of a key, so that consecutive keys spread over all buckets
+   * @param[in] key Record key
+   * @return    Hashed key
+   */
+  uint32_t hashed = key;
+  hashed          = (hashed ^ (hashed >> 16)) * 0x45D9F3BUL;
+  hashed          = (hashed ^ (hashed >> 16)) * 0x45D9F3BUL;
+  return hashed ^ (hashed >> 16);
+}  // of method hash()
+uint8_t MB85_FRAM_KVStore::fingerprint(const uint32_t hashed) const {
+  /*!
+   * @brief     Return the fingerprint of a hashed key, 0 and 1 mark empty and deleted buckets
+   * @details   The fingerprint is taken from the high bits, the home bucket from the low bits
+   * @param[in] hashed Hashed key
+   * @return    Fingerprint from 2 to 255
+   */
+  return 2 + (hashed >> 24) % 254;
+}  // of method fingerprint()
+int32_t MB85_FRAM_KVStore::find(const uint32_t key, uint8_t bucket[], int32_t *freeIndex) {
+  /*!
+   * @brief      Follow the probe sequence of a key to the bucket holding it
+   * @details    Without fingerprints each bucket in the sequence is read until the key or an empty
+   *             bucket is found. With fingerprints only buckets with a matching fingerprint are
+   *             read, and the sequence ends at an empty bucket without any bus transaction.
+   * @param[in]  key Record key
+   * @param[out] bucket Buffer of MB85_BOUNCE_SIZE bytes, holds the bucket if the key was found
+   * @param[out] freeIndex Optional, set to the first deleted or empty bucket in the sequence
+   * @return     Index of the bucket holding the key, MB85_KV_NOT_FOUND if the key isn't in the
+   *             store or MB85_KV_READ_ERROR if a bucket couldn't be read, so that a caller doesn't
+   *             take a key for missing when its bucket wasn't read
+   */
+  uint32_t hashed = hash(key);
+  uint8_t  print  = fingerprint(hashed);
+  uint16_t index  = hashed % _Buckets;  // Home bucket
+  for (uint16_t i = 0; i < _Buckets; i++) {
+    uint8_t state = MB85_KV_USED;
+    if (_Fingerprints != nullptr) {
+      state = _Fingerprints[index] == 0   ? MB85_KV_EMPTY
+              : _Fingerprints[index] == 1 ? MB85_KV_DELETED
+                                          : MB85_KV_USED;
+    }  // of if-then fingerprints
+    if (state == MB85_KV_USED && (_Fingerprints == nullptr || _Fingerprints[index] == print)) {
+      if (!readBucket(index, bucket)) return MB85_KV_READ_ERROR;
+      MB85_KVRecord record;
+      memcpy(&record, bucket, sizeof(record));
+      if (record.state == MB85_KV_USED && record.key == key) return index;
+      state = record.state;
+    }  // of if-then bucket may hold the key
+    if (state != MB85_KV_USED && freeIndex != nullptr && *freeIndex < 0) *freeIndex = index;
+    if (state == MB85_KV_EMPTY) break;  // End of the probe sequence
+    if (++index == _Buckets) index = 0;
+  }  // of for-next each bucket in the probe sequence
+  return MB85_KV_NOT_FOUND;
+}  // of method find()
+bool MB85_FRAM_KVStore::readBucket(const uint16_t index, uint8_t bucket[]) {
+  /*!
+   * @brief      Read the record header and value of a bucket with one read
+   * @param[in]  index Bucket index
+   * @param[out] bucket Buffer of MB85_BOUNCE_SIZE bytes
+   * @return     true if the bucket was read
+   */
+  uint16_t bytes = sizeof(MB85_KVRecord) + _ValueSize;
+  return _FRAM.readBlock(bucketAddress(index), bucket, bytes) == bytes;
+}  // of method readBucket()
+uint32_t MB85_FRAM_KVStore::bucketAddress(const uint16_t index) const {
+  /*!
+   * @brief     Return the memory address of a bucket
+   * @param[in] index Bucket index
+   * @return    Memory address
+   */
+  return _Start + sizeof(MB85_KVHeader) + (uint32_t)index * (sizeof(MB85_KVRecord) + _ValueSize);
+}  // of method bucketAddress()
+uint16_t MB85_FRAM_KVStore::checksum(const uint8_t bucket[]) const {
+  /*!
+   * @brief     Return the CRC16 of a record over its header fields and value bytes
+   * @param[in] bucket Record header and value, the length has to be at most the value size
+   * @return    CRC16
+   */
+  uint8_t  length = bucket[offsetof(MB85_KVRecord, length)];
+  uint16_t crc    = MB85_crc16(bucket, offsetof(MB85_KVRecord, crc));
+  return MB85_crc16(bucket + sizeof(MB85_KVRecord), length, crc);
+}  // of method checksum()
@@ -0,0 +1,109 @@
+/*! @file MB85_FRAM_KVStore.h
+ @section MB85_FRAM_KVStore_intro_section Description
+
+ Hash-indexed store of records with a 32 bit key in a region of the memory of an MB85_FRAM_Class
+ instance. The region starts with a small header describing the layout, followed by a fixed number
+ of buckets which each hold one record: the key, a state, the value length, a CRC16 over the
+ record and a value of up to the fixed value size. A key is hashed to its home bucket and collisions
+ are resolved by open addressing with linear probing, so a record is read with one targeted read
+ of its bucket. Records are inserted and updated in place with a single write of the bucket and
+ removed by marking the bucket as deleted, and a record whose CRC doesn't match after a power
+ failure during a write is reported as not found until it is written again.\n\n
+
+ Optionally an array of one byte per bucket can be passed to the constructor, which begin() fills
+ with a fingerprint of the key in each bucket. Lookups then only read buckets whose fingerprint
+ matches, which is nearly always just the bucket holding the record, and a missing key usually
+ costs no bus transaction at all, however full the store is. See main library header file for
+ details
+*/
+#ifndef MB85_FRAM_KVSTORE
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_KVSTORE
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+const uint16_t MB85_KV_MAGIC{0x4B56};   ///< Marks a valid store header, "KV"
+const uint8_t  MB85_KV_EMPTY{0x00};     ///< Bucket state of a bucket which was never used
+const uint8_t  MB85_KV_USED{0xA5};      ///< Bucket state of a bucket holding a record
+const uint8_t  MB85_KV_DELETED{0x5A};   ///< Bucket state of a bucket whose record was removed
+const int32_t  MB85_KV_NOT_FOUND{-1};   ///< find() result when the key isn't in the store
+const int32_t  MB85_KV_READ_ERROR{-2};  ///< find() result when a bucket couldn't be read
+
+/*! @brief  Key value store header, stored at the start of the region */
+struct MB85_KVHeader {
+  uint16_t magic;      ///< MB85_KV_MAGIC
+  uint16_t buckets;    ///< Number of buckets, a changed layout formats the store
+  uint8_t  valueSize;  ///< Maximum value length in bytes
+  uint8_t  reserved;   ///< Unused, 0
+  uint16_t crc;        ///< CRC16 of all preceding fields
+};
+
+/*! @brief  Record header at the start of each bucket, followed by the value bytes */
+struct MB85_KVRecord {
+  uint32_t key;     ///< Record key
+  uint8_t  state;   ///< MB85_KV_EMPTY, MB85_KV_USED or MB85_KV_DELETED
+  uint8_t  length;  ///< Value length in bytes
+  uint16_t crc;     ///< CRC16 of the preceding fields and the value bytes
+};
+
+/*! @brief  Largest value size, so that a bucket is read or written through one bounce buffer,
+            limited to the 255 bytes of the record length on cores with a large I2C buffer */
+const uint8_t MB85_KV_MAX_VALUE{
+    MB85_BOUNCE_SIZE - sizeof(MB85_KVRecord) > 255 ? 255
+                                                   : MB85_BOUNCE_SIZE - sizeof(MB85_KVRecord)};
+
+class MB85_FRAM_KVStore {
+  /*!
+   * @class   MB85_FRAM_KVStore
+   * @brief   Hash-indexed key value store in FRAM with optional fingerprints in RAM
+   */
+ public:
+  MB85_FRAM_KVStore(MB85_FRAM_Class &fram, const uint32_t start, const uint16_t buckets,
+                    const uint8_t valueSize, uint8_t fingerprints[] = nullptr);
+  bool     begin(const bool format = false);
+  bool     put(const uint32_t key, const void *value, const uint8_t length);
+  uint8_t  get(const uint32_t key, void *value, const uint8_t size);
+  bool     remove(const uint32_t key);
+  bool     clear();
+  uint16_t records() const;
+  uint16_t buckets() const;
+  uint32_t regionBytes() const;
+
+  template <typename T>
+  bool put(const uint32_t key, const T &value) {
+    /*!
+      @brief     Insert or update a record with a value of any type
+      @param[in] key Record key
+      @param[in] value Value to store, at most the value size given to the constructor
+      @return    true if the record was written
+    */
+    return put(key, (const void *)&value, sizeof(T));
+  }  // of method put()
+
+  template <typename T>
+  bool get(const uint32_t key, T &value) {
+    /*!
+      @brief      Look up a record with a value of any type
+      @param[in]  key Record key
+      @param[out] value Value read, only complete if the stored value has the size of "T"
+      @return     true if the record was found and its value has the size of "T"
+    */
+    return get(key, (void *)&value, sizeof(T)) == sizeof(T);
+  }  // of method get()
+
+ private:
+  uint32_t hash(const uint32_t key) const;
+  uint8_t  fingerprint(const uint32_t hashed) const;
+  int32_t  find(const uint32_t key, uint8_t bucket[], int32_t *freeIndex = nullptr);
+  bool     readBucket(const uint16_t index, uint8_t bucket[]);
+  uint32_t bucketAddress(const uint16_t index) const;
+  uint16_t checksum(const uint8_t bucket[]) const;
+
+  MB85_FRAM_Class &_FRAM;          ///< Memory holding the store
+  uint32_t         _Start;         ///< Memory address of the header
+  uint16_t         _Buckets;       ///< Number of buckets
+  uint8_t          _ValueSize;     ///< Maximum value length in bytes
+  uint8_t         *_Fingerprints;  ///< Fingerprint of each bucket in RAM, nullptr if not used
+  uint16_t         _Records;       ///< Number of records, counted by begin()
+  bool             _Ready;         ///< Set once begin() has found or formatted the store
+};  // of class MB85_FRAM_KVStore
+#endif
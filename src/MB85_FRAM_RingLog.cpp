@@ -0,0 +1,341 @@
+/*! @file MB85_FRAM_RingLog.cpp
+ @section MB85_FRAM_RingLog_cpp_intro_section Description
+
+ Implementation of the MB85_FRAM_RingLog class, see MB85_FRAM_RingLog.h for details
+*/
+#include "MB85_FRAM_RingLog.h"  // Include the header definition
+
+MB85_FRAM_RingLog::MB85_FRAM_RingLog(MB85_FRAM_Class &fram, const uint32_t start,
+                                     const uint32_t size, const bool overwrite)
+    : _FRAM(fram), _Start(start), _Overwrite(overwrite), _Ready(false) {
+  /*!
+   * @brief     Class constructor
+   * @param[in] fram Memory holding the log, begin() needs to have been called on it first
+   * @param[in] start Memory address of the log region
+   * @param[in] size Bytes in the log region, including the two header copies
+   * @param[in] overwrite Drop the oldest records when the log is full, otherwise refuse appends
+   */
+  _Capacity = size > 2 * sizeof(MB85_LogHeader) ? size - 2 * sizeof(MB85_LogHeader) : 0;
+  memset(&_Header, 0, sizeof(_Header));
+}  // of class constructor
+bool MB85_FRAM_RingLog::begin(const bool format) {
+  /*!
+   * @brief     Recover the log from the memory or format it
+   * @details   Both header copies are read and the valid one with the higher sequence number is
+   *            used, which takes two short reads however many records the log holds. The log is
+   *            formatted when neither copy is valid, the region size has changed or "format" is
+   *            set.
+   * @param[in] format Discard any existing log
+   * @return    true if the log is ready, false if the region doesn't fit into the memory
+   */
+  _Ready = false;
+  if (_Capacity <= MB85_LOG_LENGTH) return false;  // Region too small for a record
+  if (_Start + 2 * sizeof(MB85_LogHeader) + _Capacity > _FRAM.totalBytes()) return false;
+  MB85_LogHeader copy[2];
+  bool           valid0 = !format && readHeader(0, copy[0]);
+  bool           valid1 = !format && readHeader(1, copy[1]);
+  _Ready                = true;
+  if (valid0 && valid1) {
+    _Header = (int32_t)(copy[1].sequence - copy[0].sequence) > 0 ? copy[1] : copy[0];
+  } else if (valid0 || valid1) {
+    _Header = valid0 ? copy[0] : copy[1];
+  } else {
+    memset(&_Header, 0, sizeof(_Header));  // Empty log
+    _Header.capacity = _Capacity;
+    _Header.magic    = MB85_LOG_MAGIC;
+    _Ready           = commit();
+  }  // of if-then-else valid header copies
+  return _Ready;
+}  // of method begin()
+bool MB85_FRAM_RingLog::append(const void *record, const uint16_t length) {
+  /*!
+   * @brief     Append a record to the log
+   * @param[in] record Record bytes
+   * @param[in] length Number of bytes in the record
+   * @return    true if the record was appended, false if it doesn't fit or the memory failed
+   */
+  return append(&record, &length, 1);
+}  // of method append()
+bool MB85_FRAM_RingLog::append(const void *const records[], const uint16_t lengths[],
+                               const uint8_t count) {
+  /*!
+   * @brief     Append several records to the log at once
+   * @details   The length fields and record bytes are joined in a bounce buffer, so that small
+   *            records go out in full I2C transmissions, and the header is written once at the
+   *            end. A power failure before then leaves the log as it was before the call.
+   * @param[in] records Pointers to the bytes of each record
+   * @param[in] lengths Number of bytes in each record
+   * @param[in] count Number of records
+   * @return    true if all records were appended, false if they don't fit or the memory failed
+   */
+  if (!_Ready) return false;
+  if (count == 0) return true;  // Nothing to append
+  uint32_t bytes = 0;           // Bytes needed by all records
+  for (uint8_t i = 0; i < count; i++) bytes += MB85_LOG_LENGTH + lengths[i];
+  if (!makeRoom(bytes)) return false;
+  uint8_t  buffer[MB85_BOUNCE_SIZE];                      // Bounce buffer
+  uint16_t staged   = 0;                                  // Bytes in the bounce buffer
+  uint32_t position = wrap(_Header.head + _Header.used);  // Offset behind the newest record
+  for (uint8_t i = 0; i < count; i++) {
+    if (!stage(buffer, staged, position, (const uint8_t *)&lengths[i], MB85_LOG_LENGTH) ||
+        !stage(buffer, staged, position, (const uint8_t *)records[i], lengths[i])) {
+      return false;
+    }  // of if-then write failed
+  }    // of for-next each record
+  if (staged && !writeData(position, buffer, staged)) return false;
+  MB85_LogHeader saved = _Header;  // Header as it is in the memory
+  _Header.used += bytes;  // The records become part of the log with the header
+  _Header.records += count;
+  if (commit()) return true;
+  _Header = saved;  // Keep the header in RAM as it is in the memory
+  return false;
+}  // of method append()
+uint16_t MB85_FRAM_RingLog::peek(void *buffer, const uint16_t size) {
+  /*!
+   * @brief     Read the oldest record without removing it
+   * @param[out] buffer Buffer to read to
+   * @param[in] size Size of the buffer, a longer record is cut off
+   * @return    Length of the record, 0 if the log is empty or the memory failed
+   */
+  uint32_t cursor = _Header.head;
+  return _Header.records ? readNext(cursor, buffer, size) : 0;
+}  // of method peek()
+uint16_t MB85_FRAM_RingLog::pop(void *buffer, const uint16_t size) {
+  /*!
+   * @brief     Read and remove the oldest record
+   * @param[out] buffer Buffer to read to, may be nullptr to just remove the record
+   * @param[in] size Size of the buffer, a longer record is cut off
+   * @return    Length of the record, 0 if the log is empty or the memory failed, in which case
+   *            the record is left in the log
+   */
+  if (!_Ready || _Header.records == 0) return 0;
+  uint32_t cursor = _Header.head;
+  uint16_t length = 0;
+  if (!readRecord(cursor, buffer, buffer == nullptr ? 0 : size, length)) return 0;
+  MB85_LogHeader saved = _Header;  // Header as it is in the memory
+  _Header.head         = cursor;
+  _Header.used -= MB85_LOG_LENGTH + length;
+  _Header.records--;
+  _Header.first++;
+  if (commit()) return length;
+  _Header = saved;  // Keep the header in RAM as it is in the memory
+  return 0;
+}  // of method pop()
+uint16_t MB85_FRAM_RingLog::readNext(uint32_t &cursor, void *buffer, const uint16_t size) {
+  /*!
+   * @brief     Read the record at a cursor and move the cursor on to the next record
+   * @details   Start with the cursor returned by oldest() and call records() times to read the
+   *            whole log from the oldest to the newest record. Each record takes two reads.
+   * @param[in,out] cursor Offset of the record in the record area
+   * @param[out] buffer Buffer to read to
+   * @param[in] size Size of the buffer, a longer record is cut off
+   * @return    Length of the record, 0 if the memory failed, in which case the cursor isn't moved
+   */
+  uint16_t length = 0;
+  return readRecord(cursor, buffer, size, length) ? length : 0;
+}  // of method readNext()
+bool MB85_FRAM_RingLog::clear() {
+  /*!
+   * @brief     Remove all records, the record numbers carry on
+   * @return    true if the header was written
+   */
+  if (!_Ready) return false;
+  _Header.first += _Header.records;
+  _Header.head    = wrap(_Header.head + _Header.used);
+  _Header.used    = 0;
+  _Header.records = 0;
+  return commit();
+}  // of method clear()
+uint32_t MB85_FRAM_RingLog::oldest() const {
+  /*!
+   * @brief     Return the cursor of the oldest record for readNext()
+   * @return    Offset of the oldest record in the record area
+   */
+  return _Header.head;
+}  // of method oldest()
+uint32_t MB85_FRAM_RingLog::records() const {
+  /*!
+   * @brief     Return the number of records in the log
+   * @return    Number of records
+   */
+  return _Header.records;
+}  // of method records()
+uint32_t MB85_FRAM_RingLog::firstRecord() const {
+  /*!
+   * @brief     Return the number of the oldest record, records are numbered from 0 on in the order
+   *            they were appended since the log was formatted
+   * @return    Record number
+   */
+  return _Header.first;
+}  // of method firstRecord()
+uint32_t MB85_FRAM_RingLog::usedBytes() const {
+  /*!
+   * @brief     Return the bytes used by the records, including 2 bytes per record for its length
+   * @return    Number of bytes
+   */
+  return _Header.used;
+}  // of method usedBytes()
+uint32_t MB85_FRAM_RingLog::freeBytes() const {
+  /*!
+   * @brief     Return the bytes available before the oldest records have to be dropped
+   * @return    Number of bytes
+   */
+  return _Capacity - _Header.used;
+}  // of method freeBytes()
+uint32_t MB85_FRAM_RingLog::capacity() const {
+  /*!
+   * @brief     Return the size of the record area
+   * @return    Number of bytes
+   */
+  return _Capacity;
+}  // of method capacity()
+bool MB85_FRAM_RingLog::readHeader(const uint8_t copy, MB85_LogHeader &header) {
+  /*!
+   * @brief      Read a header copy and check it
+   * @param[in]  copy Header copy, 0 or 1
+   * @param[out] header Header read
+   * @return     true if the copy is valid and matches the region
+   */
+  if (_FRAM.read(_Start + copy * sizeof(MB85_LogHeader), header) != sizeof(header)) return false;
+  return header.magic == MB85_LOG_MAGIC && header.capacity == _Capacity &&
+         header.crc == MB85_crc16((const uint8_t *)&header, offsetof(MB85_LogHeader, crc)) &&
+         header.head < _Capacity && header.used <= _Capacity &&
+         header.records * MB85_LOG_LENGTH <= header.used;
+}  // of method readHeader()
+bool MB85_FRAM_RingLog::commit() {
+  /*!
+   * @brief     Write the header to the older of the two copies
+   * @details   The sequence number is incremented first, so the copy written becomes the current
+   *            one only once it has been written completely with a valid CRC
+   * @return    true if the header was written
+   */
+  _Header.sequence++;
+  _Header.crc = MB85_crc16((const uint8_t *)&_Header, offsetof(MB85_LogHeader, crc));
+  return _FRAM.write(_Start + (_Header.sequence & 1) * sizeof(MB85_LogHeader), _Header) ==
+         sizeof(_Header);
+}  // of method commit()
+bool MB85_FRAM_RingLog::makeRoom(const uint32_t bytes) {
+  /*!
+   * @brief     Make sure that a number of bytes can be appended
+   * @details   When overwriting, the oldest records are dropped until there is enough room, each
+   *            takes a read of its length field. The header is then written before the records
+   *            are overwritten. If a length can't be read or the header written, no record is
+   *            dropped.
+   * @param[in] bytes Bytes needed
+   * @return    true if there is room
+   */
+  if (bytes > _Capacity) return false;  // Would never fit
+  if (_Capacity - _Header.used >= bytes) return true;
+  if (!_Overwrite) return false;
+  MB85_LogHeader saved = _Header;  // Header as it is in the memory
+  while (_Capacity - _Header.used < bytes) {
+    uint16_t length = 0;  // Drop the oldest record
+    if (!recordLength(_Header.head, length)) {
+      _Header = saved;  // Nothing has been dropped
+      return false;
+    }  // of if-then length not read
+    _Header.head = wrap(_Header.head + MB85_LOG_LENGTH + length);
+    _Header.used -= MB85_LOG_LENGTH + length;
+    _Header.records--;
+    _Header.first++;
+  }  // of while not enough room
+  if (commit()) return true;
+  _Header = saved;  // Keep the header in RAM as it is in the memory
+  return false;
+}  // of method makeRoom()
+bool MB85_FRAM_RingLog::recordLength(const uint32_t offset, uint16_t &length) {
+  /*!
+   * @brief      Read the length field of a record
+   * @details    A length which doesn't fit into the bytes in use can only come from a damaged
+   *             read and is treated as a failed one
+   * @param[in]  offset Offset of the record in the record area
+   * @param[out] length Length of the record
+   * @return     true if the length was read
+   */
+  length = 0;
+  if (!readData(offset, (uint8_t *)&length, MB85_LOG_LENGTH)) return false;
+  return (uint32_t)MB85_LOG_LENGTH + length <= _Header.used;
+}  // of method recordLength()
+bool MB85_FRAM_RingLog::readRecord(uint32_t &cursor, void *buffer, const uint16_t size,
+                                   uint16_t &length) {
+  /*!
+   * @brief      Read the record at a cursor and move the cursor on to the next record
+   * @param[in,out] cursor Offset of the record in the record area, only moved on success
+   * @param[out] buffer Buffer to read to
+   * @param[in]  size Size of the buffer, a longer record is cut off
+   * @param[out] length Length of the record
+   * @return     true if the record was read
+   */
+  if (!recordLength(cursor, length)) return false;
+  uint16_t bytes = size < length ? size : length;  // Bytes fitting into the buffer
+  if (bytes && !readData(wrap(cursor + MB85_LOG_LENGTH), (uint8_t *)buffer, bytes)) return false;
+  cursor = wrap(cursor + MB85_LOG_LENGTH + length);
+  return true;
+}  // of method readRecord()
+bool MB85_FRAM_RingLog::readData(const uint32_t offset, uint8_t *data, const uint32_t length) {
+  /*!
+   * @brief     Read bytes from the record area, wrapping around at its end
+   * @param[in] offset Offset in the record area
+   * @param[out] data Buffer to read to
+   * @param[in] length Number of bytes
+   * @return    true if all bytes were read
+   */
+  uint32_t base  = _Start + 2 * sizeof(MB85_LogHeader);                        // Record area
+  uint32_t first = length < _Capacity - offset ? length : _Capacity - offset;  // Before the end
+  if (_FRAM.readBlock(base + offset, data, first) != first) return false;
+  return first == length || _FRAM.readBlock(base, data + first, length - first) == length - first;
+}  // of method readData()
+bool MB85_FRAM_RingLog::writeData(const uint32_t offset, const uint8_t *data,
+                                  const uint32_t length) {
+  /*!
+   * @brief     Write bytes to the record area, wrapping around at its end
+   * @param[in] offset Offset in the record area
+   * @param[in] data Buffer to write from
+   * @param[in] length Number of bytes
+   * @return    true if all bytes were written
+   */
+  uint32_t base  = _Start + 2 * sizeof(MB85_LogHeader);                        // Record area
+  uint32_t first = length < _Capacity - offset ? length : _Capacity - offset;  // Before the end
+  if (_FRAM.writeBlock(base + offset, data, first) != first) return false;
+  return first == length || _FRAM.writeBlock(base, data + first, length - first) == length - first;
+}  // of method writeData()
+bool MB85_FRAM_RingLog::stage(uint8_t buffer[], uint16_t &staged, uint32_t &position,
+                              const uint8_t *data, uint32_t length) {
+  /*!
+   * @brief     Add bytes to the bounce buffer, writing it to the record area whenever it is full
+   * @details   Bytes which fill the whole bounce buffer are written directly instead
+   * @param[in,out] buffer Bounce buffer of MB85_BOUNCE_SIZE bytes
+   * @param[in,out] staged Bytes in the bounce buffer
+   * @param[in,out] position Offset in the record area of the first byte in the bounce buffer
+   * @param[in] data Bytes to add
+   * @param[in] length Number of bytes
+   * @return    true unless a write failed
+   */
+  while (length) {
+    if (staged == 0 && length >= MB85_BOUNCE_SIZE) {  // Too long to be worth copying
+      if (!writeData(position, data, length)) return false;
+      position = wrap(position + length);
+      return true;
+    }  // of if-then write directly
+    uint16_t room  = MB85_BOUNCE_SIZE - staged;  // Free bytes in the bounce buffer
+    uint16_t bytes = room < length ? room : length;
+    memcpy(buffer + staged, data, bytes);
+    staged += bytes;
+    data += bytes;
+    length -= bytes;
+    if (staged == MB85_BOUNCE_SIZE) {
+      if (!writeData(position, buffer, staged)) return false;
+      position = wrap(position + staged);
+      staged   = 0;
+    }  // of if-then bounce buffer full
+  }    // of while bytes left
+  return true;
+}  // of method stage()
+uint32_t MB85_FRAM_RingLog::wrap(const uint32_t offset) const {
+  /*!
+   * @brief     Wrap an offset around to the record area
+   * @param[in] offset Offset from the start of the record area
+   * @return    Offset in the record area
+   */
+  return offset < _Capacity ? offset : offset % _Capacity;
+}  // of method wrap()
@@ -0,0 +1,83 @@
+/*! @file MB85_FRAM_RingLog.h
+ @section MB85_FRAM_RingLog_intro_section Description
+
+ Persistent append-only ring log of variable-length records in a region of the memory of an
+ MB85_FRAM_Class instance. The region starts with two copies of a small header, which hold the
+ position of the oldest record, the bytes and number of records in use and a sequence number, and
+ are protected by a CRC16. The header is written to the two copies in turn with an incremented
+ sequence number, so one valid header always survives a power failure during a write, and begin()
+ recovers the log from whichever valid copy has the higher sequence number without scanning the
+ records. The rest of the region is a ring of records, each consisting of a 2 byte length followed
+ by the record bytes.\n\n
+
+ An append writes the record bytes behind the newest record and then the header, so it takes two
+ bursts regardless of the log size and a record only becomes part of the log once its header has
+ been written. A batch of records is appended with the same two bursts and becomes part of the log
+ all at once. When the log is full the oldest records are dropped, or the append is refused when
+ overwriting was turned off. Records which are dropped to make room are removed from the header
+ before their bytes are overwritten, so a power failure never leaves a damaged record in the log.
+ The region may span several memories and the records wrap around at its end, as all addresses
+ are linear MB85_FRAM_Class addresses. See main library header file for details
+*/
+#ifndef MB85_FRAM_RINGLOG
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_RINGLOG
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+const uint16_t MB85_LOG_MAGIC{0x4C47};  ///< Marks a valid ring log header, "LG"
+const uint8_t  MB85_LOG_LENGTH{2};      ///< Bytes in the length field in front of each record
+
+/*! @brief  Ring log header, stored twice at the start of the region and written in turn */
+struct MB85_LogHeader {
+  uint32_t sequence;  ///< Incremented on every write, the valid copy with the highest is current
+  uint32_t capacity;  ///< Bytes in the record area, a changed region size formats the log
+  uint32_t head;      ///< Offset of the oldest record in the record area
+  uint32_t used;      ///< Bytes used by the records including their length fields
+  uint32_t records;   ///< Number of records in the log
+  uint32_t first;     ///< Number of the oldest record, counted since the log was formatted
+  uint16_t magic;     ///< MB85_LOG_MAGIC
+  uint16_t crc;       ///< CRC16 of all preceding fields
+};
+
+class MB85_FRAM_RingLog {
+  /*!
+   * @class   MB85_FRAM_RingLog
+   * @brief   Power-fail safe ring log of variable-length records in FRAM
+   */
+ public:
+  MB85_FRAM_RingLog(MB85_FRAM_Class &fram, const uint32_t start, const uint32_t size,
+                    const bool overwrite = true);
+  bool     begin(const bool format = false);
+  bool     append(const void *record, const uint16_t length);
+  bool     append(const void *const records[], const uint16_t lengths[], const uint8_t count);
+  uint16_t peek(void *buffer, const uint16_t size);
+  uint16_t pop(void *buffer = nullptr, const uint16_t size = 0);
+  uint16_t readNext(uint32_t &cursor, void *buffer, const uint16_t size);
+  bool     clear();
+  uint32_t oldest() const;
+  uint32_t records() const;
+  uint32_t firstRecord() const;
+  uint32_t usedBytes() const;
+  uint32_t freeBytes() const;
+  uint32_t capacity() const;
+
+ private:
+  bool     readHeader(const uint8_t copy, MB85_LogHeader &header);
+  bool     commit();
+  bool     makeRoom(const uint32_t bytes);
+  bool     recordLength(const uint32_t offset, uint16_t &length);
+  bool     readRecord(uint32_t &cursor, void *buffer, const uint16_t size, uint16_t &length);
+  bool     readData(const uint32_t offset, uint8_t *data, const uint32_t length);
+  bool     writeData(const uint32_t offset, const uint8_t *data, const uint32_t length);
+  bool     stage(uint8_t buffer[], uint16_t &staged, uint32_t &position, const uint8_t *data,
+                 uint32_t length);
+  uint32_t wrap(const uint32_t offset) const;
+
+  MB85_FRAM_Class &_FRAM;       ///< Memory holding the log
+  uint32_t         _Start;      ///< Memory address of the first header copy
+  uint32_t         _Capacity;   ///< Bytes in the record area after the two header copies
+  bool             _Overwrite;  ///< Drop the oldest records when the log is full
+  bool             _Ready;      ///< Set once begin() has found or formatted the log
+  MB85_LogHeader   _Header;     ///< Current header
+};  // of class MB85_FRAM_RingLog
+#endif
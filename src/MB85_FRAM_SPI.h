@@ -0,0 +1,184 @@
+/*! @file MB85_FRAM_SPI.h
+ @section MB85_FRAM_SPI_intro_section Description
+
+ Variant of MB85_FRAM_Class for the MB85RS memories on an SPI bus. The SPI bus and the chip select
+ pins of the memories are passed to the constructor and the memories are then used through the
+ same functions as the I2C memories. begin() identifies them with the RDID command, parts without
+ it have to be passed to begin() as a known layout. The SPI clock of 20MHz or more and the lack of
+ a buffer limit make these memories much faster: a blocking transfer sends one WRITE or READ
+ command with the memory address for each memory and then streams all its bytes in the same chip
+ select window. Each WRITE is preceded by a WREN command and FAST_READ is used from
+ MB85_SPI_FAST_READ on.\n\n
+
+ The class is kept in this header of its own so that only sketches which include it need the
+ "SPI" library. See main library header file for details
+*/
+#ifndef MB85_FRAM_SPI
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_SPI
+  #include <SPI.h>        // Standard "SPI" library
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+const uint32_t MB85_SPI_CLOCK{20000000};        ///< Default SPI clock, fine for all MB85RS
+const uint32_t MB85_SPI_FAST_READ{25000000};    ///< SPI clock from which FAST_READ is used
+const uint8_t  MB85_SPI_WREN{0x06};             ///< SPI opcode to set the write enable latch
+const uint8_t  MB85_SPI_WRITE{0x02};            ///< SPI opcode to write memory
+const uint8_t  MB85_SPI_READ{0x03};             ///< SPI opcode to read memory
+const uint8_t  MB85_SPI_FAST_READ_OP{0x0B};     ///< SPI opcode to read after a dummy byte
+const uint8_t  MB85_SPI_RDID{0x9F};             ///< SPI opcode to read the device ID
+const uint8_t  MB85_SPI_MANUFACTURER_ID{0x04};  ///< Fujitsu manufacturer ID in the SPI RDID
+const uint8_t  MB85_SPI_CONTINUATION{0x7F};     ///< Continuation code in the SPI RDID
+
+class MB85_FRAM_SPI_Class : public MB85_FRAM_Class {
+  /*!
+   * @class   MB85_FRAM_SPI_Class
+   * @brief   Access MB85RS memories on an SPI bus
+   */
+ public:
+  MB85_FRAM_SPI_Class(SPIClass &spi, const uint8_t csPins[], const uint8_t chipCount,
+                      const uint32_t spiClock = MB85_SPI_CLOCK)
+      : _SPI(spi), _SpiSettings(spiClock, MSBFIRST, SPI_MODE0) {
+    /*!
+     * @brief     Class constructor for MB85RS memories on an SPI bus
+     * @details   The memories are treated as being on a single bus, chip select pins past
+     *            MB85_MAX_DEVICES are ignored
+     * @param[in] spi SPI bus the memories are attached to, e.g. "SPI"
+     * @param[in] csPins Array with the chip select pin of each memory in address order
+     * @param[in] chipCount Number of entries in "csPins"
+     * @param[in] spiClock SPI clock in Herz, defaults to MB85_SPI_CLOCK
+     */
+    _Clock   = spiClock;
+    _Command = command;
+    _CsCount = chipCount < MB85_MAX_DEVICES ? chipCount : MB85_MAX_DEVICES;
+    for (uint8_t i = 0; i < _CsCount; i++) _CsPin[i] = csPins[i];
+  }  // of class constructor
+  uint8_t begin() {
+    /*!
+      @brief     Start the SPI bus and identify the memory on each chip select pin
+      @details   The memories are identified by their RDID response, see readSpiID()
+      @return    Number of MB85 devices detected
+    */
+    MB85_Type types[MB85_MAX_DEVICES] = {};  // Memory on each chip select pin
+    startBus();
+    for (uint8_t i = 0; i < _CsCount; i++) {
+      uint32_t memSize = readSpiID(_CsPin[i]);  // Memory size from the device ID
+      uint8_t  bits    = 0;                     // log2 of memory size
+      while (memSize && (1UL << bits) < memSize) bits++;
+      types[i] = (MB85_Type)bits;  // Type is log2 of memory size, MB85_NONE without an ID
+    }                              // of for-next each chip select pin
+    buildTable(types, MB85_CONTIGUOUS, _CsPin, _CsCount);
+    return _DeviceCount;
+  }  // of method begin()
+  uint8_t begin(const MB85_Type layout[MB85_MAX_DEVICES]) {
+    /*!
+      @brief     Start the SPI bus with a known set of devices
+      @param[in] layout Type of the memory on each chip select pin in the order given to the
+                 constructor, MB85_NONE if absent
+      @return    Number of MB85 devices in the layout
+    */
+    startBus();
+    buildTable(layout, MB85_CONTIGUOUS, _CsPin, _CsCount);
+    return _DeviceCount;
+  }  // of method begin()
+
+ private:
+  void startBus() {
+    /*!
+      @brief     Start the SPI bus with all memories deselected
+    */
+    for (uint8_t i = 0; i < _CsCount; i++) {
+      digitalWrite(_CsPin[i], HIGH);  // Deselect before switching to output to avoid a glitch
+      pinMode(_CsPin[i], OUTPUT);
+    }  // of for-next each chip select pin
+    _SPI.begin();
+  }  // of method startBus()
+  uint32_t readSpiID(const uint8_t csPin) {
+    /*!
+      @brief     Read the device ID of an SPI memory and return its size
+      @details   The RDID command returns the Fujitsu manufacturer ID 0x04, the continuation code
+                 0x7F and two product ID bytes, the lower 5 bits of the first of which hold the
+                 density as log2 of the size in kB. Parts without the command, e.g. the MB85RS64,
+                 leave MISO floating, which reads as 0xFF, and have to be passed to begin() as a
+                 known layout.
+      @param[in] csPin Chip select pin of the memory
+      @return    Memory size in bytes, 0 if no memory answered
+    */
+    uint8_t id[4] = {0};  // Manufacturer ID, continuation code and product ID
+    _SPI.beginTransaction(_SpiSettings);
+    digitalWrite(csPin, LOW);
+    _SPI.transfer(MB85_SPI_RDID);
+    _SPI.transfer(id, sizeof(id));
+    digitalWrite(csPin, HIGH);
+    _SPI.endTransaction();
+    if (id[0] != MB85_SPI_MANUFACTURER_ID || id[1] != MB85_SPI_CONTINUATION) return 0;
+    uint8_t density = id[2] & 0x1F;             // log2 of the size in kB
+    if (density < 3 || density > 9) return 0;  // 8kB to 512kB are known
+    return 1024UL << density;
+  }  // of method readSpiID()
+  static uint32_t command(MB85_FRAM_Class &fram, const uint8_t device, const uint32_t memAddr,
+                          const MB85_Operation operation, uint8_t *buffer, const uint8_t value,
+                          const uint32_t length) {
+    /*!
+      @brief     Perform one SPI command on a memory, called by the transfer engine
+      @details   A write or fill first sets the write enable latch with WREN in a chip select
+                 window of its own, as the memory resets the latch after every WRITE. The READ,
+                 FAST_READ or WRITE opcode is followed by the memory address, 3 bytes for memories
+                 of more than 64kB and 2 otherwise, and all data bytes are then streamed in the
+                 same chip select window, as the address counter increments in the memory.
+                 FAST_READ adds a dummy byte and is only used from an SPI clock of
+                 MB85_SPI_FAST_READ on. The caller has to make sure that the bytes don't cross the
+                 end of the memory. SPI has no acknowledge, so the bytes are always reported as
+                 transferred. The command is added to the counters if attachStats() was called,
+                 at 8 clock cycles per byte including the WREN command of a write.
+      @param[in] fram Instance of this class
+      @param[in] device Memory number
+      @param[in] memAddr Memory address on the device
+      @param[in] operation Read, write or fill
+      @param[in,out] buffer Buffer to read to or write from, unused for a fill
+      @param[in] value Byte value for a fill
+      @param[in] length Number of bytes
+      @return    Number of bytes transferred
+    */
+    MB85_FRAM_SPI_Class &self         = static_cast<MB85_FRAM_SPI_Class &>(fram);
+    SPIClass            &spi          = self._SPI;
+    uint8_t              csPin        = self._ChipAddress[device];
+    uint8_t              addressBytes = self._ChipType[device] > MB85RS512T ? 3 : 2;
+    bool                 fast = operation == MB85_READ && self._Clock >= MB85_SPI_FAST_READ;
+    spi.beginTransaction(self._SpiSettings);
+    if (operation != MB85_READ) {
+      digitalWrite(csPin, LOW);
+      spi.transfer(MB85_SPI_WREN);  // Set the write enable latch
+      digitalWrite(csPin, HIGH);
+    }  // of if-then write or fill
+    digitalWrite(csPin, LOW);
+    spi.transfer(operation != MB85_READ ? MB85_SPI_WRITE
+                 : fast                 ? MB85_SPI_FAST_READ_OP
+                                        : MB85_SPI_READ);
+    for (uint8_t i = addressBytes; i > 0; i--) {
+      spi.transfer((uint8_t)(memAddr >> (8 * (i - 1))));  // Send the address MSB first
+    }                                                      // of for-next each address byte
+    if (fast) spi.transfer(0);                             // Dummy byte
+    if (operation == MB85_READ) {
+      spi.transfer(buffer, length);  // Data is read in place
+    } else if (operation == MB85_WRITE) {
+      for (uint32_t i = 0; i < length; i++) spi.transfer(buffer[i]);  // Keep the buffer intact
+    } else {
+      for (uint32_t i = 0; i < length; i++) spi.transfer(value);
+    }  // of if-then-else operation
+    digitalWrite(csPin, HIGH);
+    spi.endTransaction();
+    if (self._Stats != nullptr) {
+      MB85_Stats &stats = self._Stats[device];
+      stats.bytes += length;
+      stats.transactions += operation == MB85_READ ? 1 : 2;
+      stats.clocks += 8 * (1 + addressBytes + (fast ? 1 : 0) + length + (operation != MB85_READ));
+    }  // of if-then counters kept
+    return length;
+  }  // of method command()
+
+  SPIClass   &_SPI;                            ///< SPI bus of the memories
+  SPISettings _SpiSettings;                    ///< SPI clock, bit order and mode
+  uint8_t     _CsPin[MB85_MAX_DEVICES] = {0};  ///< Chip select pin of each memory
+  uint8_t     _CsCount                 = 0;    ///< Number of chip select pins
+};                                             // of class MB85_FRAM_SPI_Class
+#endif
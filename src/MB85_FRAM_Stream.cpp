@@ -0,0 +1,181 @@
+/*! @file MB85_FRAM_Stream.cpp
+ @section MB85_FRAM_Stream_cpp_intro_section Description
+
+ Implementation of the MB85_FRAM_Stream class, see MB85_FRAM_Stream.h for details
+*/
+#include "MB85_FRAM_Stream.h"  // Include the header definition
+
+MB85_FRAM_Stream::MB85_FRAM_Stream(MB85_FRAM_Class &fram, const uint32_t start,
+                                   const uint32_t length)
+    : _FRAM(fram), _Start(start), _Length(length) {
+  /*!
+   * @brief     Class constructor
+   * @param[in] fram Memory holding the region, begin() needs to have been called before the first
+   *            access
+   * @param[in] start Memory address of the region
+   * @param[in] length Bytes in the region, 0 for the rest of the memory
+   */
+}  // of class constructor
+MB85_FRAM_Stream::~MB85_FRAM_Stream() {
+  /*!
+   * @brief   Class destructor
+   * @details Writes out any pending bytes
+   */
+  flush();
+}  // of class destructor
+int MB85_FRAM_Stream::available() {
+  /*!
+   * @brief     Return the number of bytes left to read up to the end of the region
+   * @return    Number of bytes, limited to the largest value an int holds on all processors
+   */
+  uint32_t left = size() - _Position;
+  return left > INT16_MAX ? INT16_MAX : (int)left;
+}  // of method available()
+int MB85_FRAM_Stream::read() {
+  /*!
+   * @brief     Read the next byte and move on
+   * @return    Byte read, -1 at the end of the region or if the memory didn't respond
+   */
+  int value = peek();
+  if (value >= 0) _Position++;
+  return value;
+}  // of method read()
+int MB85_FRAM_Stream::peek() {
+  /*!
+   * @brief     Return the next byte without moving on
+   * @return    Byte read, -1 at the end of the region or if the memory didn't respond
+   */
+  if (_Position - _WindowStart >= _WindowLength && !fillWindow()) return -1;
+  return _Window[_Position - _WindowStart];
+}  // of method peek()
+size_t MB85_FRAM_Stream::write(uint8_t value) {
+  /*!
+   * @brief     Write a byte and move on
+   * @details   The byte is added to the pending bytes, which are written out first if they don't
+   *            end at the current position
+   * @param[in] value Byte to write
+   * @return    1, or 0 at the end of the region
+   */
+  if (_Position >= size()) return 0;
+  if (_PendingLength && _PendingStart + _PendingLength != _Position) flush();  // Position jumped
+  if (_PendingLength == 0) _PendingStart = _Position;
+  _Pending[_PendingLength++] = value;
+  updateWindow(_Position++, &value, 1);
+  if (_PendingLength == sizeof(_Pending)) flush();  // Buffer is full
+  return 1;
+}  // of method write()
+size_t MB85_FRAM_Stream::write(const uint8_t *buffer, size_t size) {
+  /*!
+   * @brief     Write a block of bytes and move on
+   * @details   Once no bytes are pending, the rest of a block which fills at least the whole buffer
+   *            is written directly with one writeBlock()
+   * @param[in] buffer Bytes to write
+   * @param[in] size Number of bytes
+   * @return    Number of bytes written, less at the end of the region
+   */
+  uint32_t left = this->size() - _Position;  // Bytes up to the end of the region
+  if (size > left) size = left;
+  size_t written = 0;
+  while (written < size) {
+    if (_PendingLength == 0 && size - written >= sizeof(_Pending)) {
+      uint32_t bytes = _FRAM.writeBlock(_Start + _Position, buffer + written, size - written);
+      updateWindow(_Position, buffer + written, bytes);
+      _Position += bytes;
+      return written + bytes;
+    }  // of if-then write directly
+    write(buffer[written++]);
+  }  // of while bytes left
+  return written;
+}  // of method write()
+void MB85_FRAM_Stream::flush() {
+  /*!
+   * @brief     Write out the pending bytes
+   */
+  if (_PendingLength == 0) return;
+  _FRAM.writeBlock(_Start + _PendingStart, _Pending, _PendingLength);
+  _PendingLength = 0;
+}  // of method flush()
+size_t MB85_FRAM_Stream::read(uint8_t *buffer, size_t length) {
+  /*!
+   * @brief      Read a block of bytes and move on
+   * @details    Bytes in the read-ahead window are copied from it, the rest of a block which fills
+   *             at least the whole window is read directly with one readBlock()
+   * @param[out] buffer Buffer to read to
+   * @param[in]  length Number of bytes
+   * @return     Number of bytes read, less at the end of the region
+   */
+  uint32_t left = size() - _Position;  // Bytes up to the end of the region
+  if (length > left) length = left;
+  size_t done = 0;
+  while (done < length) {
+    if (_Position - _WindowStart < _WindowLength) {  // Copy from the window
+      uint32_t bytes = _WindowStart + _WindowLength - _Position;
+      if (bytes > length - done) bytes = length - done;
+      memcpy(buffer + done, _Window + (_Position - _WindowStart), bytes);
+      _Position += bytes;
+      done += bytes;
+    } else if (length - done >= sizeof(_Window)) {  // Read the rest directly
+      flush();
+      uint32_t bytes = _FRAM.readBlock(_Start + _Position, buffer + done, length - done);
+      _Position += bytes;
+      return done + bytes;
+    } else if (!fillWindow()) {
+      break;  // Memory didn't respond
+    }         // of if-then-else position in the window
+  }           // of while bytes left
+  return done;
+}  // of method read()
+bool MB85_FRAM_Stream::seek(const uint32_t position) {
+  /*!
+   * @brief     Move to a position in the region, the read-ahead window and pending bytes are kept
+   * @param[in] position Position from the start of the region
+   * @return    true if the position is within the region or at its end
+   */
+  if (position > size()) return false;
+  _Position = position;
+  return true;
+}  // of method seek()
+uint32_t MB85_FRAM_Stream::position() const {
+  /*!
+   * @brief     Return the current position
+   * @return    Position from the start of the region
+   */
+  return _Position;
+}  // of method position()
+uint32_t MB85_FRAM_Stream::size() {
+  /*!
+   * @brief     Return the size of the region
+   * @return    Number of bytes, up to the end of the memory if no length was given
+   */
+  if (_Length) return _Length;
+  uint32_t total = _FRAM.totalBytes();
+  return total > _Start ? total - _Start : 0;
+}  // of method size()
+bool MB85_FRAM_Stream::fillWindow() {
+  /*!
+   * @brief     Read the window at the current position
+   * @details   Pending bytes are written out first, so that the window holds them
+   * @return    true if at least one byte was read
+   */
+  uint32_t bytes = size() - _Position;  // Bytes up to the end of the region
+  if (bytes > sizeof(_Window)) bytes = sizeof(_Window);
+  flush();
+  _WindowStart  = _Position;
+  _WindowLength = bytes ? _FRAM.readBlock(_Start + _Position, _Window, bytes) : 0;
+  return _WindowLength != 0;
+}  // of method fillWindow()
+void MB85_FRAM_Stream::updateWindow(const uint32_t position, const uint8_t *data,
+                                    const uint32_t length) {
+  /*!
+   * @brief     Copy written bytes into the part of the read-ahead window they overlap
+   * @param[in] position Position of the first byte written
+   * @param[in] data Bytes written
+   * @param[in] length Number of bytes
+   */
+  uint32_t first = position > _WindowStart ? position : _WindowStart;
+  uint32_t last  = position + length < _WindowStart + _WindowLength ? position + length
+                                                                    : _WindowStart + _WindowLength;
+  if (first < last) {
+    memcpy(_Window + (first - _WindowStart), data + (first - position), last - first);
+  }  // of if-then bytes overlap the window
+}  // of method updateWindow()
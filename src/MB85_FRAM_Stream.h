@@ -0,0 +1,62 @@
+/*! @file MB85_FRAM_Stream.h
+ @section MB85_FRAM_Stream_intro_section Description
+
+ Arduino Stream over a region of the memory of an MB85_FRAM_Class instance. Reading and writing
+ share one position, which moves on with every byte and can be set with seek(), so the region can
+ be used like a file and passed to anything expecting a Stream or Print, e.g. to dump or restore a
+ memory image over Serial. A loop of single byte or element reads costs one address phase for each
+ read() call, the stream instead keeps a read-ahead window of BUFFER_LENGTH bytes, which is filled
+ with a single read, and a write-combining buffer of BUFFER_LENGTH - 2 bytes, which is written out
+ in a single I2C transmission when it is full, when the position jumps or on flush(). Sequential
+ access therefore costs one address phase per I2C buffer, and blocks of at least the buffer size
+ are transferred directly in full-length transfers.\n\n
+
+ Writes are copied into the read-ahead window, so reads always return the bytes last written
+ through the stream. Accesses made directly through the MB85_FRAM_Class instance aren't seen by
+ the stream, so flush() should be called before and seek() to a new position after them. The
+ MB85_FRAM_Array template in "MB85_FRAM_Array.h" uses the stream for indexed access to an array
+ of any data type. See main library header file for details
+*/
+#ifndef MB85_FRAM_STREAM
+  /** @brief  Guard code to prevent multiple definitions of the class*/
+  #define MB85_FRAM_STREAM
+  #include <Stream.h>  // Arduino Stream base class
+
+  #include "MB85_FRAM.h"  // Include the FRAM class definition
+
+class MB85_FRAM_Stream : public Stream {
+  /*!
+   * @class   MB85_FRAM_Stream
+   * @brief   Buffered Arduino Stream over a region of FRAM
+   */
+ public:
+  MB85_FRAM_Stream(MB85_FRAM_Class &fram, const uint32_t start = 0, const uint32_t length = 0);
+  ~MB85_FRAM_Stream();
+  virtual int    available();
+  virtual int    read();
+  virtual int    peek();
+  virtual size_t write(uint8_t value);
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  virtual void   flush();
+  using Print::write;
+  size_t   read(uint8_t *buffer, size_t length);
+  bool     seek(const uint32_t position);
+  uint32_t position() const;
+  uint32_t size();
+
+ private:
+  bool fillWindow();
+  void updateWindow(const uint32_t position, const uint8_t *data, const uint32_t length);
+
+  MB85_FRAM_Class &_FRAM;                        ///< Memory holding the region
+  uint32_t         _Start;                       ///< Memory address of the region
+  uint32_t         _Length;                      ///< Bytes in the region, 0 up to memory end
+  uint32_t         _Position      = 0;           ///< Position of the next byte in the region
+  uint8_t          _Window[BUFFER_LENGTH];       ///< Read-ahead window
+  uint32_t         _WindowStart   = 0;           ///< Position of the first byte in the window
+  uint8_t          _WindowLength  = 0;           ///< Bytes in the window, 0 if empty
+  uint8_t          _Pending[BUFFER_LENGTH - 2];  ///< Write-combining buffer
+  uint32_t         _PendingStart  = 0;           ///< Position of the first pending byte
+  uint8_t          _PendingLength = 0;           ///< Bytes waiting to be written
+};                                               // of class MB85_FRAM_Stream
+#endif